@@ -0,0 +1,46 @@
+#include <benchmark/benchmark.h>
+#include "reference.h"
+
+namespace {
+    void MatrixReference(benchmark::State& state) {
+        std::vector<reference::Frame> frames = reference::GenerateFrames();
+        gvr::Mat4f model = ToGvr(reference::Model());
+        gvr::Mat4f reticle = ToGvr(reference::Reticle());
+        std::array<float, 16> mvp_model[2], mvp_cursor[2];
+        unsigned long index = 0;
+        for (auto _ : state) {
+            //the viewer keeps the field of view, only the pose changes every frame
+            reference::Frame f = frames[index++ % frames.size()];
+            f.fov[0] = frames[0].fov[0];
+            f.fov[1] = frames[0].fov[1];
+            reference::ReferenceFrame(f, model, reticle, mvp_model, mvp_cursor);
+            benchmark::DoNotOptimize(mvp_model);
+            benchmark::DoNotOptimize(mvp_cursor);
+        }
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    void MatrixGlm(benchmark::State& state) {
+        std::vector<reference::Frame> frames = reference::GenerateFrames();
+        glm::mat4 model = reference::Model();
+        glm::mat4 reticle = reference::Reticle();
+        gvr::Rectf fov[2];
+        glm::mat4 projection[2], mvp_model[2], mvp_cursor[2];
+
+        //correctness against the removed helpers is checked by daydream-matrix-check
+        memset(fov, 0, sizeof(fov));
+        unsigned long index = 0;
+        for (auto _ : state) {
+            reference::Frame f = frames[index++ % frames.size()];
+            f.fov[0] = frames[0].fov[0];
+            f.fov[1] = frames[0].fov[1];
+            reference::GlmFrame(f, model, reticle, fov, projection, mvp_model, mvp_cursor);
+            benchmark::DoNotOptimize(mvp_model);
+            benchmark::DoNotOptimize(mvp_cursor);
+        }
+        state.SetItemsProcessed(state.iterations());
+    }
+}
+
+BENCHMARK(MatrixReference);
+BENCHMARK(MatrixGlm);
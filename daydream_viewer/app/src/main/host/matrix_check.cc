@@ -0,0 +1,34 @@
+#include <cstdio>
+#include <cstdlib>
+#include "reference.h"
+
+//uniforms of the viewer computed with glm have to match the removed gvr::Mat4f helpers
+int main() {
+    std::vector<reference::Frame> frames = reference::GenerateFrames();
+    glm::mat4 model = reference::Model();
+    glm::mat4 reticle = reference::Reticle();
+    gvr::Mat4f reference_model = ToGvr(model);
+    gvr::Mat4f reference_reticle = ToGvr(reticle);
+    gvr::Rectf fov[2];
+    glm::mat4 projection[2], mvp_model[2], mvp_cursor[2];
+    std::array<float, 16> expected_model[2], expected_cursor[2];
+    memset(fov, 0, sizeof(fov));
+
+    float error = 0;
+    for (reference::Frame& f : frames) {
+        reference::ReferenceFrame(f, reference_model, reference_reticle, expected_model, expected_cursor);
+        reference::GlmFrame(f, model, reticle, fov, projection, mvp_model, mvp_cursor);
+        for (int eye = 0; eye < 2; ++eye) {
+            error = glm::max(error, reference::Difference(expected_model[eye], mvp_model[eye]));
+            error = glm::max(error, reference::Difference(expected_cursor[eye], mvp_cursor[eye]));
+        }
+    }
+
+    //the check is not an assert so that it runs in release builds too
+    printf("%d frames, max relative error %g\n", (int) frames.size(), error);
+    if (error > reference::kMaxError) {
+        printf("glm matrices differ from the removed helpers\n");
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
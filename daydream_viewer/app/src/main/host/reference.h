@@ -0,0 +1,139 @@
+#ifndef REFERENCE_H
+#define REFERENCE_H
+
+#include <array>
+#include <random>
+#include <vector>
+#include "matrix.h"
+
+namespace reference {
+    //results of glm have to match the removed helpers up to float rounding
+    const float kMaxError = 1e-4f;
+    const int kCases = 1000;
+
+    //helpers of the viewer before it used glm, the expected results
+    inline std::array<float, 16> MatrixToGLArray(const gvr::Mat4f& matrix) {
+        std::array<float, 16> result;
+        for (int i = 0; i < 4; ++i)
+            for (int j = 0; j < 4; ++j)
+                result[j * 4 + i] = matrix.m[i][j];
+        return result;
+    }
+
+    inline gvr::Mat4f MatrixMul(const gvr::Mat4f& matrix1, const gvr::Mat4f& matrix2) {
+        gvr::Mat4f result;
+        for (int i = 0; i < 4; ++i) {
+            for (int j = 0; j < 4; ++j) {
+                result.m[i][j] = 0.0f;
+                for (int k = 0; k < 4; ++k)
+                    result.m[i][j] += matrix1.m[i][k] * matrix2.m[k][j];
+            }
+        }
+        return result;
+    }
+
+    inline gvr::Mat4f ReferencePerspective(const gvr::Rectf& fov, float z_near, float z_far) {
+        const float x_left = -std::tan(fov.left * M_PI / 180.0f) * z_near;
+        const float x_right = std::tan(fov.right * M_PI / 180.0f) * z_near;
+        const float y_bottom = -std::tan(fov.bottom * M_PI / 180.0f) * z_near;
+        const float y_top = std::tan(fov.top * M_PI / 180.0f) * z_near;
+        gvr::Mat4f result;
+        memset(&result.m[0][0], 0, sizeof(result.m));
+        result.m[0][0] = (2 * z_near) / (x_right - x_left);
+        result.m[0][2] = (x_right + x_left) / (x_right - x_left);
+        result.m[1][1] = (2 * z_near) / (y_top - y_bottom);
+        result.m[1][2] = (y_top + y_bottom) / (y_top - y_bottom);
+        result.m[2][2] = (z_near + z_far) / (z_near - z_far);
+        result.m[2][3] = (2 * z_near * z_far) / (z_near - z_far);
+        result.m[3][2] = -1;
+        return result;
+    }
+
+    inline gvr::Mat4f ReferenceQuatToMatrix(const gvr::ControllerQuat& quat) {
+        const float x = quat.qx, y = quat.qy, z = quat.qz, w = quat.qw;
+        return {{{1.0f - 2.0f * (y * y + z * z), 2.0f * (x * y - z * w), 2.0f * (x * z + y * w), 0.0f},
+                 {2.0f * (x * y + z * w), 1.0f - 2.0f * (x * x + z * z), 2.0f * (y * z - x * w), 0.0f},
+                 {2.0f * (x * z - y * w), 2.0f * (y * z + x * w), 1.0f - 2.0f * (x * x + y * y), 0.0f},
+                 {0.0f, 0.0f, 0.0f, 1.0f}}};
+    }
+
+    //inputs of one frame as the viewer gets them from gvr
+    struct Frame {
+        gvr::Mat4f head_view;
+        gvr::Mat4f eye_from_head[2];
+        gvr::Rectf fov[2];
+        gvr::ControllerQuat controller;
+    };
+
+    inline gvr::Mat4f RandomPose(std::mt19937& random) {
+        std::uniform_real_distribution<float> angle(-3.14f, 3.14f);
+        std::uniform_real_distribution<float> offset(-2.0f, 2.0f);
+        glm::mat4 pose = glm::translate(glm::mat4(1.0f), glm::vec3(offset(random), offset(random), offset(random)));
+        pose = glm::rotate(pose, angle(random), glm::normalize(glm::vec3(offset(random), offset(random), 1.0f)));
+        return ToGvr(pose);
+    }
+
+    inline std::vector<Frame> GenerateFrames() {
+        std::mt19937 random(1234);
+        std::uniform_real_distribution<float> fov(30.0f, 50.0f);
+        std::uniform_real_distribution<float> q(-1.0f, 1.0f);
+        std::vector<Frame> output(kCases);
+        for (Frame& f : output) {
+            f.head_view = RandomPose(random);
+            for (int eye = 0; eye < 2; ++eye) {
+                f.eye_from_head[eye] = ToGvr(glm::translate(glm::mat4(1.0f), glm::vec3(eye ? -0.03f : 0.03f, 0, 0)));
+                f.fov[eye] = {fov(random), fov(random), fov(random), fov(random)};
+            }
+            glm::quat quat = glm::normalize(glm::quat(q(random), q(random), q(random), q(random)));
+            f.controller = {quat.x, quat.y, quat.z, quat.w};
+        }
+        return output;
+    }
+
+    //per frame matrices of the removed code, the arrays are what went to glUniformMatrix4fv
+    inline void ReferenceFrame(const Frame& f, const gvr::Mat4f& model, const gvr::Mat4f& reticle,
+                        std::array<float, 16>* mvp_model, std::array<float, 16>* mvp_cursor) {
+        gvr::Mat4f cursor = MatrixMul(ReferenceQuatToMatrix(f.controller), reticle);
+        for (int eye = 0; eye < 2; ++eye) {
+            gvr::Mat4f eye_view = MatrixMul(f.eye_from_head[eye], f.head_view);
+            gvr::Mat4f perspective = ReferencePerspective(f.fov[eye], 1, 10000);
+            mvp_model[eye] = MatrixToGLArray(MatrixMul(perspective, MatrixMul(eye_view, model)));
+            mvp_cursor[eye] = MatrixToGLArray(MatrixMul(perspective, MatrixMul(eye_view, cursor)));
+        }
+    }
+
+    //per frame matrices of the viewer now, projection is cached while the field of view stays
+    inline void GlmFrame(const Frame& f, const glm::mat4& model, const glm::mat4& reticle, gvr::Rectf* fov,
+                  glm::mat4* projection, glm::mat4* mvp_model, glm::mat4* mvp_cursor) {
+        glm::mat4 cursor = ControllerQuatToMatrix(f.controller) * reticle;
+        const glm::mat4 head_view = ToGlm(f.head_view);
+        for (int eye = 0; eye < 2; ++eye) {
+            const glm::mat4 eye_view = ToGlm(f.eye_from_head[eye]) * head_view;
+            if (memcmp(&f.fov[eye], &fov[eye], sizeof(gvr::Rectf)) != 0) {
+                fov[eye] = f.fov[eye];
+                projection[eye] = PerspectiveMatrixFromView(f.fov[eye], 1, 10000);
+            }
+            mvp_model[eye] = projection[eye] * eye_view * model;
+            mvp_cursor[eye] = projection[eye] * eye_view * cursor;
+        }
+    }
+
+    inline glm::mat4 Model() {
+        return glm::scale(glm::mat4(1.0f), glm::vec3(100.0f));
+    }
+
+    inline glm::mat4 Reticle() {
+        return glm::scale(glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, -3.0f)), glm::vec3(0.04f));
+    }
+
+    inline float Difference(const std::array<float, 16>& expected, const glm::mat4& actual) {
+        float output = 0;
+        for (int i = 0; i < 16; ++i) {
+            float scale = glm::max(1.0f, glm::abs(expected[i]));
+            output = glm::max(output, glm::abs(expected[i] - glm::value_ptr(actual)[i]) / scale);
+        }
+        return output;
+    }
+}
+
+#endif
@@ -16,11 +16,14 @@ LOCAL_C_INCLUDES += $(PROJECT_ROOT)/third_party/glm/ \
 LOCAL_CFLAGS    += -DNOTANGO
 LOCAL_SRC_FILES := renderer_jni.cc \
                    renderer.cc \
+                   ../../../../../open_constructor/app/src/main/jni/data/atlas.cc \
+                   ../../../../../open_constructor/app/src/main/jni/data/etc1.cc \
                    ../../../../../open_constructor/app/src/main/jni/data/file3d.cc \
                    ../../../../../open_constructor/app/src/main/jni/data/image.cc \
-                   ../../../../../open_constructor/app/src/main/jni/data/mesh.cc
+                   ../../../../../open_constructor/app/src/main/jni/data/mesh.cc \
+                   ../../../../../open_constructor/app/src/main/jni/gl/textures.cc
 
-LOCAL_LDLIBS    := -llog -lGLESv2 -L$(SYSROOT)/usr/lib -lz -landroid
+LOCAL_LDLIBS    := -llog -lGLESv2 -lGLESv3 -L$(SYSROOT)/usr/lib -lz -landroid
 include $(BUILD_SHARED_LIBRARY)
 
 $(call import-add-path, $(PROJECT_ROOT))
@@ -0,0 +1,41 @@
+#ifndef MATRIX_H
+#define MATRIX_H
+
+#include <assert.h>
+#include <cmath>
+#include <cstring>
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+#include "glm/gtc/quaternion.hpp"
+#include "glm/gtc/type_ptr.hpp"
+#include "vr/gvr/capi/include/gvr_types.h"
+
+// Conversions between gvr and glm, they do not depend on GL so that the benchmark builds on the host.
+
+// gvr matrices are row major, glm matrices are column major.
+inline glm::mat4 ToGlm(const gvr::Mat4f& matrix) {
+  return glm::transpose(glm::make_mat4(&matrix.m[0][0]));
+}
+
+inline gvr::Mat4f ToGvr(const glm::mat4& matrix) {
+  gvr::Mat4f result;
+  memcpy(&result.m[0][0], glm::value_ptr(glm::transpose(matrix)), sizeof(result.m));
+  return result;
+}
+
+inline glm::mat4 PerspectiveMatrixFromView(const gvr::Rectf& fov, float z_near, float z_far) {
+  const float x_left = -std::tan(fov.left * M_PI / 180.0f) * z_near;
+  const float x_right = std::tan(fov.right * M_PI / 180.0f) * z_near;
+  const float y_bottom = -std::tan(fov.bottom * M_PI / 180.0f) * z_near;
+  const float y_top = std::tan(fov.top * M_PI / 180.0f) * z_near;
+
+  assert(x_left < x_right && y_bottom < y_top && z_near < z_far && z_near > 0.0f && z_far > 0.0f);
+  return glm::frustum(x_left, x_right, y_bottom, y_top, z_near, z_far);
+}
+
+inline glm::mat4 ControllerQuatToMatrix(const gvr::ControllerQuat& quat) {
+  return glm::mat4_cast(glm::quat(quat.qw, quat.qx, quat.qy, quat.qz));
+}
+
+#endif
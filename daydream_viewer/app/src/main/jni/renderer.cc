@@ -1,11 +1,15 @@
+#include "matrix.h"  // NOLINT
 #include "renderer.h"  // NOLINT
 #include "shaders.h"  // NOLINT
+#include "data/atlas.h"
 #include "data/file3d.h"
+#include "gl/textures.h"
 
 #include <android/log.h>
 #include <assert.h>
 #include <stdlib.h>
 #include <cmath>
+#include <cstring>
 #include <random>
 
 namespace {
@@ -25,76 +29,6 @@ float reticle_vertices_[] = {
         1.f, 1.f, 0.0f,
 };
 
-static std::array<float, 16> MatrixToGLArray(const gvr::Mat4f& matrix) {
-  std::array<float, 16> result;
-  for (int i = 0; i < 4; ++i) {
-    for (int j = 0; j < 4; ++j) {
-      result[j * 4 + i] = matrix.m[i][j];
-    }
-  }
-  return result;
-}
-
-static std::array<float, 4> MatrixVectorMul(const gvr::Mat4f& matrix, const std::array<float, 4>& vec) {
-  std::array<float, 4> result;
-  for (int i = 0; i < 4; ++i) {
-    result[i] = 0;
-    for (int k = 0; k < 4; ++k) {
-      result[i] += matrix.m[i][k] * vec[k];
-    }
-  }
-  return result;
-}
-
-static gvr::Mat4f MatrixMul(const gvr::Mat4f& matrix1, const gvr::Mat4f& matrix2) {
-  gvr::Mat4f result;
-  for (int i = 0; i < 4; ++i) {
-    for (int j = 0; j < 4; ++j) {
-      result.m[i][j] = 0.0f;
-      for (int k = 0; k < 4; ++k) {
-        result.m[i][j] += matrix1.m[i][k] * matrix2.m[k][j];
-      }
-    }
-  }
-  return result;
-}
-
-static std::array<float, 3> Vec4ToVec3(const std::array<float, 4>& vec) {
-  return {vec[0], vec[1], vec[2]};
-}
-
-static gvr::Mat4f PerspectiveMatrixFromView(const gvr::Rectf& fov, float z_near, float z_far) {
-  gvr::Mat4f result;
-  const float x_left = -std::tan(fov.left * M_PI / 180.0f) * z_near;
-  const float x_right = std::tan(fov.right * M_PI / 180.0f) * z_near;
-  const float y_bottom = -std::tan(fov.bottom * M_PI / 180.0f) * z_near;
-  const float y_top = std::tan(fov.top * M_PI / 180.0f) * z_near;
-  const float zero = 0.0f;
-
-  assert(x_left < x_right && y_bottom < y_top && z_near < z_far && z_near > zero && z_far > zero);
-  const float X = (2 * z_near) / (x_right - x_left);
-  const float Y = (2 * z_near) / (y_top - y_bottom);
-  const float A = (x_right + x_left) / (x_right - x_left);
-  const float B = (y_top + y_bottom) / (y_top - y_bottom);
-  const float C = (z_near + z_far) / (z_near - z_far);
-  const float D = (2 * z_near * z_far) / (z_near - z_far);
-
-  for (int i = 0; i < 4; ++i) {
-    for (int j = 0; j < 4; ++j) {
-      result.m[i][j] = 0.0f;
-    }
-  }
-  result.m[0][0] = X;
-  result.m[0][2] = A;
-  result.m[1][1] = Y;
-  result.m[1][2] = B;
-  result.m[2][2] = C;
-  result.m[2][3] = D;
-  result.m[3][2] = -1;
-
-  return result;
-}
-
 static gvr::Rectf ModulateRect(const gvr::Rectf& rect, float width, float height) {
   gvr::Rectf result = {rect.left * width, rect.right * width, rect.bottom * height, rect.top * height};
   return result;
@@ -117,38 +51,6 @@ static gvr::Sizei HalfPixelCount(const gvr::Sizei& in) {
   out.height = (7 * in.height) / 10;
   return out;
 }
-
-static gvr::Mat4f ControllerQuatToMatrix(const gvr::ControllerQuat& quat) {
-  gvr::Mat4f result;
-  const float x = quat.qx;
-  const float x2 = quat.qx * quat.qx;
-  const float y = quat.qy;
-  const float y2 = quat.qy * quat.qy;
-  const float z = quat.qz;
-  const float z2 = quat.qz * quat.qz;
-  const float w = quat.qw;
-  const float xy = quat.qx * quat.qy;
-  const float xz = quat.qx * quat.qz;
-  const float xw = quat.qx * quat.qw;
-  const float yz = quat.qy * quat.qz;
-  const float yw = quat.qy * quat.qw;
-  const float zw = quat.qz * quat.qw;
-
-  const float m11 = 1.0f - 2.0f * y2 - 2.0f * z2;
-  const float m12 = 2.0f * (xy - zw);
-  const float m13 = 2.0f * (xz + yw);
-  const float m21 = 2.0f * (xy + zw);
-  const float m22 = 1.0f - 2.0f * x2 - 2.0f * z2;
-  const float m23 = 2.0f * (yz - xw);
-  const float m31 = 2.0f * (xz - yw);
-  const float m32 = 2.0f * (yz + xw);
-  const float m33 = 1.0f - 2.0f * x2 - 2.0f * y2;
-
-  return {{{m11, m12, m13, 0.0f},
-           {m21, m22, m23, 0.0f},
-           {m31, m32, m33, 0.0f},
-           {0.0f, 0.0f, 0.0f, 1.0f}}};
-}
 }  // anonymous namespace
 
 Renderer::Renderer(gvr_context* gvr_context, std::string filename)
@@ -170,6 +72,11 @@ Renderer::Renderer(gvr_context* gvr_context, std::string filename)
   oc::File3d io(filename, false);
   textured_ = io.GetType() == oc::OBJ;
   io.ReadModel(20000, static_meshes_);
+  if (textured_)
+    oc::Atlas::Process(static_meshes_, 20000);
+  for (oc::Mesh& mesh : static_meshes_)
+    if (mesh.image && mesh.imageOwner)
+      mesh.image->Compress();
 }
 
 Renderer::~Renderer() {
@@ -178,6 +85,17 @@ Renderer::~Renderer() {
 void Renderer::InitializeGl() {
   gvr_api_->InitializeGl();
 
+  // Both eyes are drawn in one pass where the context allows it.
+  const char* version = reinterpret_cast<const char*>(glGetString(GL_VERSION));
+  const char* extensions = reinterpret_cast<const char*>(glGetString(GL_EXTENSIONS));
+  const bool gles3 = version && strstr(version, "OpenGL ES 3");
+  stereo_mode_ = kTwoPass;
+  if (gles3 && extensions && strstr(extensions, "GL_OVR_multiview2") &&
+      gvr_api_->IsFeatureSupported(GVR_FEATURE_MULTIVIEW))
+    stereo_mode_ = kMultiview;
+  else if (gles3)
+    stereo_mode_ = kInstanced;
+
   int index = textured_ ? 0 : 1;
   const int vertex_shader = LoadGLShader(GL_VERTEX_SHADER, &kTextureVertexShaders[index]);
   const int fragment_shader = LoadGLShader(GL_FRAGMENT_SHADER, &kTextureFragmentShaders[index]);
@@ -185,10 +103,25 @@ void Renderer::InitializeGl() {
   const int reticle_vertex_shader = LoadGLShader(GL_VERTEX_SHADER, &kReticleVertexShaders[0]);
   const int reticle_fragment_shader = LoadGLShader(GL_FRAGMENT_SHADER, &kReticleFragmentShaders[0]);
 
-  model_program_ = glCreateProgram();
-  glAttachShader(model_program_, vertex_shader);
-  glAttachShader(model_program_, fragment_shader);
-  glLinkProgram(model_program_);
+  // Multiview falls back to instanced stereo and that one to drawing eyes separately.
+  while (stereo_mode_ != kTwoPass) {
+    const char* vertex_prefix = kStereoVertexPrefixes[stereo_mode_];
+    const char* fragment_prefix = kStereoFragmentPrefixes[stereo_mode_];
+    model_program_ = LinkProgram(
+        LoadStereoShader(GL_VERTEX_SHADER, vertex_prefix, kStereoTextureVertexShaders[index]),
+        LoadStereoShader(GL_FRAGMENT_SHADER, fragment_prefix, kStereoTextureFragmentShaders[index]));
+    cursor_program_ = LinkProgram(
+        LoadStereoShader(GL_VERTEX_SHADER, vertex_prefix, kStereoReticleVertexShaders[0]),
+        LoadStereoShader(GL_FRAGMENT_SHADER, fragment_prefix, kStereoReticleFragmentShaders[0]));
+    if (model_program_ && cursor_program_)
+      break;
+    LOGE("Stereo shaders failed to link.");
+    stereo_mode_ = stereo_mode_ == kMultiview ? kInstanced : kTwoPass;
+  }
+  if (stereo_mode_ == kTwoPass)
+    model_program_ = LinkProgram(vertex_shader, fragment_shader);
+  LOGI("Stereo mode: %s", stereo_mode_ == kMultiview ? "MULTIVIEW" :
+                          stereo_mode_ == kInstanced ? "INSTANCED" : "TWO PASS");
   glUseProgram(model_program_);
 
   model_position_param_ = glGetAttribLocation(model_program_, "a_Position");
@@ -200,26 +133,29 @@ void Renderer::InitializeGl() {
   model_translatex_param_ = glGetUniformLocation(model_program_, "u_X");
   model_translatey_param_ = glGetUniformLocation(model_program_, "u_Y");
   model_translatez_param_ = glGetUniformLocation(model_program_, "u_Z");
+  model_viewport_param_ = glGetUniformLocation(model_program_, "u_Viewport");
+  model_rect_param_ = glGetUniformLocation(model_program_, "u_Rect");
 
-  reticle_program_ = glCreateProgram();
-  glAttachShader(reticle_program_, reticle_vertex_shader);
-  glAttachShader(reticle_program_, reticle_fragment_shader);
-  glLinkProgram(reticle_program_);
+  reticle_program_ = LinkProgram(reticle_vertex_shader, reticle_fragment_shader);
   glUseProgram(reticle_program_);
 
   reticle_position_param_ = glGetAttribLocation(reticle_program_, "a_Position");
   reticle_modelview_projection_param_ = glGetUniformLocation(reticle_program_, "u_MVP");
 
+  // Daydream cursor is drawn into the eye buffer, so it has to use the same stereo technique.
+  if (stereo_mode_ == kTwoPass)
+    cursor_program_ = reticle_program_;
+  cursor_position_param_ = glGetAttribLocation(cursor_program_, "a_Position");
+  cursor_modelview_projection_param_ = glGetUniformLocation(cursor_program_, "u_MVP");
+  cursor_viewport_param_ = glGetUniformLocation(cursor_program_, "u_Viewport");
+
   // Object first appears directly in front of user.
-  model_model_ = {{{100.0f, 0.0f, 0.0f, 0.0f},
-                   {0.0f, 100.0f, 0.0f, 0.0},
-                   {0.0f, 0.0f, 100.0f, 0.0f},
-                   {0.0f, 0.0f, 0.0f, 1.0f}}};
+  model_model_ = glm::scale(glm::mat4(1.0f), glm::vec3(100.0f));
   const float rs = 0.04f;  // Reticle scale.
-  model_reticle_ = {{{rs, 0.0f, 0.0f, 0.0f},
-                     {0.0f, rs, 0.0f, 0.0f},
-                     {0.0f, 0.0f, rs, -kReticleDistance},
-                     {0.0f, 0.0f, 0.0f, 1.0f}}};
+  model_reticle_ = glm::scale(glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, -kReticleDistance)),
+                              glm::vec3(rs));
+  // Projections are computed with the first frame.
+  memset(fov_, 0, sizeof(fov_));
 
   // Because we are using 2X MSAA, we can render to half as many pixels and
   // achieve similar quality.
@@ -230,7 +166,9 @@ void Renderer::InitializeGl() {
   specs[0].SetColorFormat(GVR_COLOR_FORMAT_RGBA_8888);
   specs[0].SetDepthStencilFormat(GVR_DEPTH_STENCIL_FORMAT_DEPTH_16);
   specs[0].SetSamples(2);
-  specs[0].SetSize(render_size_);
+  specs[0].SetSize(BufferSize(render_size_));
+  if (stereo_mode_ == kMultiview)
+    specs[0].SetMultiviewLayers(2);
 
   specs.push_back(gvr_api_->CreateBufferSpec());
   specs[1].SetSize(reticle_render_size_);
@@ -298,29 +236,44 @@ void Renderer::DrawFrame() {
   const gvr_rectf fullscreen = { 0, 1, 0, 1 };
   reticle_viewport.SetSourceUv(fullscreen);
 
-  gvr::Mat4f controller_matrix = ControllerQuatToMatrix(gvr_controller_state_.GetOrientation());
-  model_cursor_ = MatrixMul(controller_matrix, model_reticle_);
+  model_cursor_ = ControllerQuatToMatrix(gvr_controller_state_.GetOrientation()) * model_reticle_;
 
-  gvr::Mat4f eye_views[2];
+  const glm::mat4 head_view = ToGlm(head_view_);
   for (int eye = 0; eye < 2; ++eye) {
     const gvr::Eye gvr_eye = eye == 0 ? GVR_LEFT_EYE : GVR_RIGHT_EYE;
-    const gvr::Mat4f eye_from_head = gvr_api_->GetEyeFromHeadMatrix(gvr_eye);
-    eye_views[eye] = MatrixMul(eye_from_head, head_view_);
+    const glm::mat4 eye_from_head = ToGlm(gvr_api_->GetEyeFromHeadMatrix(gvr_eye));
+    const glm::mat4 eye_view = eye_from_head * head_view;
 
     viewport_list_->GetBufferViewport(eye, viewport[eye]);
-    reticle_viewport.SetTransform(MatrixMul(eye_from_head, model_reticle_));
+    if (stereo_mode_ == kMultiview) {
+      // Every eye has its own layer of the buffer.
+      viewport[eye]->SetSourceUv(fullscreen);
+      viewport[eye]->SetSourceLayer(eye);
+      viewport_list_->SetBufferViewport(eye, *viewport[eye]);
+    }
+    reticle_viewport.SetTransform(ToGvr(eye_from_head * model_reticle_));
     reticle_viewport.SetTargetEye(gvr_eye);
     viewport_list_->SetBufferViewport(2 + eye, reticle_viewport);
 
-    modelview_model_[eye] = MatrixMul(eye_views[eye], model_model_);
+    // Projection changes only with the viewer, it is recomputed only when the field of view does.
     const gvr_rectf fov = viewport[eye]->GetSourceFov();
-    const gvr::Mat4f perspective = PerspectiveMatrixFromView(fov, 1, 10000);
-    modelview_projection_model_[eye] = MatrixMul(perspective, modelview_model_[eye]);
-    modelview_projection_cursor_[eye] = MatrixMul(perspective, MatrixMul(eye_views[eye], model_cursor_));
+    if (memcmp(&fov, &fov_[eye], sizeof(fov)) != 0) {
+      fov_[eye] = fov;
+      projection_[eye] = PerspectiveMatrixFromView(fov, 1, 10000);
+    }
+    modelview_model_[eye] = eye_view * model_model_;
+    modelview_projection_model_[eye] = projection_[eye] * modelview_model_[eye];
+    modelview_projection_cursor_[eye] = projection_[eye] * eye_view * model_cursor_;
   }
 
   cur_position = 0.95f * cur_position + 0.05f * dst_position;
 
+  // Textures are uploaded once for both eyes within the frame budget.
+  oc::GLTextures::NewFrame();
+  for (oc::Mesh& mesh : static_meshes_)
+    if (mesh.image && (mesh.image->GetTexture() == -1))
+      oc::GLTextures::Upload(mesh.image);
+
   glEnable(GL_DEPTH_TEST);
   glDisable(GL_CULL_FACE);
   glDisable(GL_SCISSOR_TEST);
@@ -330,8 +283,16 @@ void Renderer::DrawFrame() {
   frame.BindBuffer(0);
   glClearColor(0.1f, 0.1f, 0.1f, 0.5f);  // Dark background so text shows up.
   glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-  DrawWorld(kLeftView);
-  DrawWorld(kRightView);
+  if (stereo_mode_ == kTwoPass) {
+    DrawWorld(kLeftView);
+    DrawWorld(kRightView);
+  } else {
+    const gvr::Sizei size = BufferSize(render_size_);
+    glViewport(0, 0, size.width, size.height);
+    DrawModel(kLeftView);
+    if (gvr_viewer_type_ == GVR_VIEWER_TYPE_DAYDREAM)
+      DrawDaydreamCursor(kLeftView);
+  }
   frame.Unbind();
 
   frame.BindBuffer(1);
@@ -352,16 +313,14 @@ void Renderer::PrepareFramebuffer() {
   const gvr::Sizei recommended_size = HalfPixelCount(gvr_api_->GetMaximumEffectiveRenderTargetSize());
   if (render_size_.width != recommended_size.width || render_size_.height != recommended_size.height) {
     // We need to resize the framebuffer.
-    swapchain_->ResizeBuffer(0, recommended_size);
+    swapchain_->ResizeBuffer(0, BufferSize(recommended_size));
     render_size_ = recommended_size;
   }
 }
 
 void Renderer::OnTriggerEvent() {
-  glm::mat4 left = glm::make_mat4(MatrixToGLArray(modelview_model_[kLeftView]).data());
-  glm::mat4 right = glm::make_mat4(MatrixToGLArray(modelview_model_[kRightView]).data());
-  glm::vec4 lv = glm::vec4(0, 0, 1, 1) * left;
-  glm::vec4 rv = glm::vec4(0, 0, 1, 1) * right;
+  glm::vec4 lv = glm::vec4(0, 0, 1, 1) * modelview_model_[kLeftView];
+  glm::vec4 rv = glm::vec4(0, 0, 1, 1) * modelview_model_[kRightView];
   lv /= fabs(lv.w);
   rv /= fabs(rv.w);
   dst_position += (lv + rv) * 0.0025f;
@@ -379,6 +338,37 @@ void Renderer::OnResume() {
   ResumeControllerApiAsNeeded();
 }
 
+gvr::Sizei Renderer::BufferSize(gvr::Sizei size) {
+  // Multiview buffer layer holds a single eye.
+  if (stereo_mode_ == kMultiview)
+    size.width /= 2;
+  return size;
+}
+
+void Renderer::DrawArrays(int count) {
+  if (stereo_mode_ == kInstanced)
+    glDrawArraysInstanced(GL_TRIANGLES, 0, count, 2);
+  else
+    glDrawArrays(GL_TRIANGLES, 0, count);
+}
+
+int Renderer::LinkProgram(int vertex_shader, int fragment_shader) {
+  if (!vertex_shader || !fragment_shader)
+    return 0;
+  int program = glCreateProgram();
+  glAttachShader(program, vertex_shader);
+  glAttachShader(program, fragment_shader);
+  glLinkProgram(program);
+
+  int linkStatus;
+  glGetProgramiv(program, GL_LINK_STATUS, &linkStatus);
+  if (linkStatus == 0) {
+    glDeleteProgram(program);
+    program = 0;
+  }
+  return program;
+}
+
 int Renderer::LoadGLShader(int type, const char** shadercode) {
   int shader = glCreateShader(type);
   glShaderSource(shader, 1, shadercode, nullptr);
@@ -405,6 +395,39 @@ int Renderer::LoadGLShader(int type, const char** shadercode) {
   return shader;
 }
 
+int Renderer::LoadStereoShader(int type, const char* prefix, const char* shadercode) {
+  std::string code = std::string(prefix) + shadercode;
+  const char* source = code.c_str();
+  return LoadGLShader(type, &source);
+}
+
+void Renderer::SetStereoUniforms(int mvp_param, int viewport_param, int rect_param, glm::mat4* mvp) {
+  // Single pass gets matrices of both eyes, they are stored next to each other.
+  const int count = stereo_mode_ == kTwoPass ? 1 : 2;
+  glUniformMatrix4fv(mvp_param, count, GL_FALSE, glm::value_ptr(mvp[0]));
+  if (stereo_mode_ != kInstanced)
+    return;
+
+  // Instances are placed into viewports of eyes in clip space.
+  float viewports[8];
+  float rects[8];
+  for (int eye = 0; eye < 2; ++eye) {
+    const gvr::BufferViewport& viewport = eye == kLeftView ? viewport_left_ : viewport_right_;
+    const gvr::Rectf uv = viewport.GetSourceUv();
+    viewports[eye * 4 + 0] = uv.right - uv.left;
+    viewports[eye * 4 + 1] = uv.right + uv.left - 1.0f;
+    viewports[eye * 4 + 2] = uv.top - uv.bottom;
+    viewports[eye * 4 + 3] = uv.top + uv.bottom - 1.0f;
+    rects[eye * 4 + 0] = uv.left * render_size_.width;
+    rects[eye * 4 + 1] = uv.right * render_size_.width;
+    rects[eye * 4 + 2] = uv.bottom * render_size_.height;
+    rects[eye * 4 + 3] = uv.top * render_size_.height;
+  }
+  glUniform4fv(viewport_param, 2, viewports);
+  if (rect_param >= 0)
+    glUniform4fv(rect_param, 2, rects);
+}
+
 void Renderer::DrawWorld(ViewType view) {
     const gvr::BufferViewport& viewport = view == kLeftView ? viewport_left_ : viewport_right_;
     const gvr::Recti pixel_rect = CalculatePixelSpaceRect(render_size_, viewport.GetSourceUv());
@@ -418,59 +441,52 @@ void Renderer::DrawWorld(ViewType view) {
 
 void Renderer::DrawModel(ViewType view) {
   glUseProgram(model_program_);
-  float* matrix = MatrixToGLArray(modelview_projection_model_[view]).data();
   glUniform1f(model_translatex_param_, cur_position.x);
   glUniform1f(model_translatey_param_, cur_position.y);
   glUniform1f(model_translatez_param_, cur_position.z);
-  glUniformMatrix4fv(model_modelview_projection_param_, 1, GL_FALSE, MatrixToGLArray(modelview_projection_model_[view]).data());
+  SetStereoUniforms(model_modelview_projection_param_, model_viewport_param_, model_rect_param_,
+                    &modelview_projection_model_[view]);
 
   glEnableVertexAttribArray(model_position_param_);
+  glEnableVertexAttribArray(model_uv_param_);
+  long last_texture = -1;
   for(oc::Mesh& mesh : static_meshes_) {
-    if (mesh.image && (mesh.texture == -1)) {
-      GLuint textureID;
-      glGenTextures(1, &textureID);
-      mesh.texture = textureID;
-      glBindTexture(GL_TEXTURE_2D, textureID);
-      glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-      glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-      glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-      glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-      glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, mesh.image->GetWidth(), mesh.image->GetHeight(),
-                             0, GL_RGB, GL_UNSIGNED_BYTE, mesh.image->GetData());
-    }
     glVertexAttribPointer(model_position_param_, 3, GL_FLOAT, false, 0, mesh.vertices.data());
     if (textured_)
     {
-      glBindTexture(GL_TEXTURE_2D, (unsigned int)mesh.texture);
+      long texture = oc::GLTextures::Use(mesh.image);
+      if (last_texture != texture) {
+        last_texture = texture;
+        glBindTexture(GL_TEXTURE_2D, (unsigned int)last_texture);
+      }
       glVertexAttribPointer(model_uv_param_, 2, GL_FLOAT, false, 0, mesh.uv.data());
-      glDrawArrays(GL_TRIANGLES, 0, mesh.vertices.size());
+      DrawArrays(mesh.vertices.size());
     }
     else
     {
       glVertexAttribPointer(model_uv_param_, 4, GL_UNSIGNED_BYTE, GL_TRUE, 0, mesh.colors.data());
-      glDrawArrays(GL_TRIANGLES, 0, mesh.vertices.size());
+      DrawArrays(mesh.vertices.size());
     }
   }
   glDisableVertexAttribArray(model_position_param_);
+  glDisableVertexAttribArray(model_uv_param_);
 }
 
 void Renderer::DrawDaydreamCursor(ViewType view) {
-  glUseProgram(reticle_program_);
-    glUniformMatrix4fv(reticle_modelview_projection_param_, 1, GL_FALSE, MatrixToGLArray(modelview_projection_cursor_[view]).data());
-  glVertexAttribPointer(reticle_position_param_, kCoordsPerVertex, GL_FLOAT, false, 0, reticle_vertices_);
-  glEnableVertexAttribArray(reticle_position_param_);
-  glDrawArrays(GL_TRIANGLES, 0, 6);
-  glDisableVertexAttribArray(reticle_position_param_);
+  glUseProgram(cursor_program_);
+  SetStereoUniforms(cursor_modelview_projection_param_, cursor_viewport_param_, -1,
+                    &modelview_projection_cursor_[view]);
+  glVertexAttribPointer(cursor_position_param_, kCoordsPerVertex, GL_FLOAT, false, 0, reticle_vertices_);
+  glEnableVertexAttribArray(cursor_position_param_);
+  DrawArrays(6);
+  glDisableVertexAttribArray(cursor_position_param_);
 }
 
 void Renderer::DrawCardboardReticle() {
   glViewport(0, 0, reticle_render_size_.width, reticle_render_size_.height);
   glUseProgram(reticle_program_);
-  const gvr::Mat4f uniform_matrix = {{{1.f, 0.f, 0.f, 0.f},
-                                      {0.f, 1.f, 0.f, 0.f},
-                                      {0.f, 0.f, 1.f, 0.f},
-                                      {0.f, 0.f, 0.f, 1.f}}};
-  glUniformMatrix4fv(reticle_modelview_projection_param_, 1, GL_FALSE, MatrixToGLArray(uniform_matrix).data());
+  const glm::mat4 uniform_matrix(1.0f);
+  glUniformMatrix4fv(reticle_modelview_projection_param_, 1, GL_FALSE, glm::value_ptr(uniform_matrix));
   glVertexAttribPointer(reticle_position_param_, kCoordsPerVertex, GL_FLOAT, false, 0, reticle_vertices_);
   glEnableVertexAttribArray(reticle_position_param_);
   glDrawArrays(GL_TRIANGLES, 0, 6);
@@ -2,7 +2,7 @@
 #define RENDERER_H
 
 #include <EGL/egl.h>
-#include <GLES2/gl2.h>
+#include <GLES3/gl3.h>
 #include <jni.h>
 
 #include <memory>
@@ -33,6 +33,16 @@ class Renderer {
     kLeftView,
     kRightView
   };
+  enum StereoMode {
+    kMultiview,
+    kInstanced,
+    kTwoPass
+  };
+  gvr::Sizei BufferSize(gvr::Sizei size);
+  void DrawArrays(int count);
+  int LinkProgram(int vertex_shader, int fragment_shader);
+  int LoadStereoShader(int type, const char* prefix, const char* shadercode);
+  void SetStereoUniforms(int mvp_param, int viewport_param, int rect_param, glm::mat4* mvp);
   void DrawWorld(ViewType view);
   void DrawCardboardReticle();
   void DrawModel(ViewType view);
@@ -57,23 +67,32 @@ class Renderer {
   int model_modelview_projection_param_;
   bool model_textured_;
 
+  int model_viewport_param_;
+  int model_rect_param_;
+
   int reticle_position_param_;
   int reticle_modelview_projection_param_;
 
+  StereoMode stereo_mode_;
+  int cursor_program_;
+  int cursor_position_param_;
+  int cursor_modelview_projection_param_;
+  int cursor_viewport_param_;
+
   const gvr::Sizei reticle_render_size_;
   bool textured_;
 
   gvr::Mat4f head_view_;
-  gvr::Mat4f camera_;
-  gvr::Mat4f view_;
-  gvr::Mat4f model_model_;
-  gvr::Mat4f model_reticle_;
-  gvr::Mat4f model_cursor_;
+  glm::mat4 model_model_;
+  glm::mat4 model_reticle_;
+  glm::mat4 model_cursor_;
   gvr::Sizei render_size_;
 
-  gvr::Mat4f modelview_projection_model_[2];
-  gvr::Mat4f modelview_projection_cursor_[2];
-  gvr::Mat4f modelview_model_[2];
+  gvr::Rectf fov_[2];
+  glm::mat4 projection_[2];
+  glm::mat4 modelview_projection_model_[2];
+  glm::mat4 modelview_projection_cursor_[2];
+  glm::mat4 modelview_model_[2];
 
   float reticle_distance_;
   std::unique_ptr<gvr::ControllerApi> gvr_controller_api_;
@@ -92,4 +92,151 @@ static const char* kReticleFragmentShaders[] = { R"glsl(
     })glsl"
 };
 
+// Prefixes selecting single pass stereo technique of kStereo* shaders.
+static const char* kStereoVertexPrefixes[] = {
+    "#version 300 es\n"
+    "#extension GL_OVR_multiview2 : require\n"
+    "layout(num_views = 2) in;\n"
+    "#define EYE int(gl_ViewID_OVR)\n",
+    "#version 300 es\n"
+    "#define INSTANCED\n"
+    "#define EYE gl_InstanceID\n"
+};
+
+static const char* kStereoFragmentPrefixes[] = {
+    "#version 300 es\n",
+    "#version 300 es\n"
+    "#define INSTANCED\n"
+};
+
+static const char* kStereoTextureVertexShaders[] = {
+    R"glsl(
+    uniform mat4 u_MVP[2];
+    uniform vec4 u_Viewport[2];
+    uniform float u_X;
+    uniform float u_Y;
+    uniform float u_Z;
+    in vec4 a_Position;
+    in vec2 a_UV;
+    out vec2 v_UV;
+    #ifdef INSTANCED
+    flat out int v_Eye;
+    #endif
+
+    void main() {
+      v_UV.x = a_UV.x;
+      v_UV.y = 1.0 - a_UV.y;
+      vec4 pos = a_Position;
+      pos.x += u_X;
+      pos.y += u_Y;
+      pos.z += u_Z;
+      gl_Position = u_MVP[EYE] * pos;
+    #ifdef INSTANCED
+      // Instance is moved into viewport of its eye.
+      vec4 viewport = u_Viewport[EYE];
+      gl_Position.x = gl_Position.x * viewport.x + gl_Position.w * viewport.y;
+      gl_Position.y = gl_Position.y * viewport.z + gl_Position.w * viewport.w;
+      v_Eye = EYE;
+    #endif
+    })glsl",
+    R"glsl(
+    uniform mat4 u_MVP[2];
+    uniform vec4 u_Viewport[2];
+    uniform float u_X;
+    uniform float u_Y;
+    uniform float u_Z;
+    in vec4 a_Position;
+    in vec4 a_Color;
+    out vec4 v_Color;
+    #ifdef INSTANCED
+    flat out int v_Eye;
+    #endif
+
+    void main() {
+      v_Color = a_Color;
+      vec4 pos = a_Position;
+      pos.x += u_X;
+      pos.y += u_Y;
+      pos.z += u_Z;
+      gl_Position = u_MVP[EYE] * pos;
+    #ifdef INSTANCED
+      // Instance is moved into viewport of its eye.
+      vec4 viewport = u_Viewport[EYE];
+      gl_Position.x = gl_Position.x * viewport.x + gl_Position.w * viewport.y;
+      gl_Position.y = gl_Position.y * viewport.z + gl_Position.w * viewport.w;
+      v_Eye = EYE;
+    #endif
+    })glsl"
+};
+
+static const char* kStereoTextureFragmentShaders[] = {
+    R"glsl(
+    precision mediump float;
+    uniform sampler2D color_texture;
+    in vec2 v_UV;
+    out vec4 o_Color;
+    #ifdef INSTANCED
+    uniform vec4 u_Rect[2];
+    flat in int v_Eye;
+    #endif
+
+    void main() {
+    #ifdef INSTANCED
+      // Triangles crossing the border of eyes are cut off.
+      vec4 rect = u_Rect[v_Eye];
+      if (gl_FragCoord.x < rect.x || gl_FragCoord.x > rect.y ||
+          gl_FragCoord.y < rect.z || gl_FragCoord.y > rect.w) discard;
+    #endif
+      o_Color = texture(color_texture, v_UV);
+    })glsl",
+    R"glsl(
+    precision mediump float;
+    in vec4 v_Color;
+    out vec4 o_Color;
+    #ifdef INSTANCED
+    uniform vec4 u_Rect[2];
+    flat in int v_Eye;
+    #endif
+
+    void main() {
+    #ifdef INSTANCED
+      // Triangles crossing the border of eyes are cut off.
+      vec4 rect = u_Rect[v_Eye];
+      if (gl_FragCoord.x < rect.x || gl_FragCoord.x > rect.y ||
+          gl_FragCoord.y < rect.z || gl_FragCoord.y > rect.w) discard;
+    #endif
+      o_Color = v_Color;
+    })glsl"
+};
+
+static const char* kStereoReticleVertexShaders[] = { R"glsl(
+    uniform mat4 u_MVP[2];
+    uniform vec4 u_Viewport[2];
+    in vec4 a_Position;
+    out vec2 v_Coords;
+
+    void main() {
+      v_Coords = a_Position.xy;
+      gl_Position = u_MVP[EYE] * a_Position;
+    #ifdef INSTANCED
+      vec4 viewport = u_Viewport[EYE];
+      gl_Position.x = gl_Position.x * viewport.x + gl_Position.w * viewport.y;
+      gl_Position.y = gl_Position.y * viewport.z + gl_Position.w * viewport.w;
+    #endif
+    })glsl"
+};
+
+static const char* kStereoReticleFragmentShaders[] = { R"glsl(
+    precision mediump float;
+    in vec2 v_Coords;
+    out vec4 o_Color;
+
+    void main() {
+      float r = length(v_Coords);
+      float alpha = smoothstep(0.5, 0.6, r) * (1.0 - smoothstep(0.8, 0.9, r));
+      if (alpha == 0.0) discard;
+      o_Color = vec4(alpha);
+    })glsl"
+};
+
 #endif  // TREASUREHUNT_APP_SRC_MAIN_JNI_TREASUREHUNTSHADERS_H_ // NOLINT
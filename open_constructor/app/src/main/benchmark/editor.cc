@@ -0,0 +1,113 @@
+#include "benchmark/memory.h"
+#include "benchmark/scan.h"
+#include "editor/effector.h"
+#include "editor/selector.h"
+
+namespace {
+    class BenchmarkRasterizer : public oc::Rasterizer {
+    public:
+        BenchmarkRasterizer() : spans(0) {}
+        virtual void Process(unsigned long&, int& x1, int& x2, int&, double&, double&) { spans += x2 - x1; }
+        long spans;
+    };
+
+    void RasterizerVertices(benchmark::State& state) {
+        std::vector<oc::Mesh> scan = oc::BenchmarkScan::Generate((int) state.range(0), 0, 16);
+        BenchmarkRasterizer rasterizer;
+        rasterizer.SetResolution(oc::BenchmarkScan::kScreenWidth, oc::BenchmarkScan::kScreenHeight);
+        glm::mat4 world2screen = oc::BenchmarkScan::GetWorld2Screen();
+        oc::BenchmarkMemory::Start();
+        for (auto _ : state)
+            for (oc::Mesh& m : scan)
+                rasterizer.AddVertices(m.vertices, world2screen, true);
+        benchmark::DoNotOptimize(rasterizer.spans);
+        oc::BenchmarkScan::Destroy(scan);
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+        oc::BenchmarkMemory::Report(state);
+    }
+
+    void RasterizerUVS(benchmark::State& state) {
+        std::vector<oc::Mesh> scan = oc::BenchmarkScan::Generate((int) state.range(0), 0, 16);
+        BenchmarkRasterizer rasterizer;
+        rasterizer.SetResolution(1024, 1024);
+        oc::BenchmarkMemory::Start();
+        for (auto _ : state)
+            for (oc::Mesh& m : scan)
+                rasterizer.AddUVS(m.uv, std::vector<unsigned int>());
+        benchmark::DoNotOptimize(rasterizer.spans);
+        oc::BenchmarkScan::Destroy(scan);
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+        oc::BenchmarkMemory::Report(state);
+    }
+
+    enum Operation { RECT, OBJECT, TRIANGLE, INCREASE, DECREASE, COMPLETE };
+
+    //every iteration starts from the same selection with a new selector
+    void SelectorOperation(benchmark::State& state, Operation operation) {
+        std::vector<oc::Mesh> scan = oc::BenchmarkScan::Generate((int) state.range(0), 0.25f, 16);
+        std::vector<oc::Mesh> model;
+        glm::mat4 world2screen = oc::BenchmarkScan::GetWorld2Screen();
+        float x = oc::BenchmarkScan::kScreenWidth / 2;
+        float y = oc::BenchmarkScan::kScreenHeight / 2;
+        oc::BenchmarkMemory::Start();
+        for (auto _ : state) {
+            oc::BenchmarkMemory::Pause(state);
+            model = scan;
+            oc::Selector selector;
+            selector.Init(oc::BenchmarkScan::kScreenWidth, oc::BenchmarkScan::kScreenHeight);
+            oc::BenchmarkMemory::Resume(state);
+            if (operation == RECT)
+                selector.SelectRect(model, world2screen, x / 2, y / 2, x * 3 / 2, y * 3 / 2);
+            else if (operation == OBJECT)
+                selector.SelectObject(model, world2screen, x, y);
+            else if (operation == TRIANGLE)
+                selector.SelectTriangle(model, world2screen, x, y);
+            else if (operation == INCREASE)
+                selector.IncreaseSelection(model);
+            else if (operation == DECREASE)
+                selector.DecreaseSelection(model);
+            else if (operation == COMPLETE)
+                selector.CompleteSelection(model, false);
+            benchmark::DoNotOptimize(selector.GetCenter(model));
+        }
+        oc::BenchmarkScan::Destroy(scan);
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+        oc::BenchmarkMemory::Report(state);
+    }
+
+    //every iteration starts from the same scan with empty undo history, the second argument is percentage selected
+    void EffectorEffect(benchmark::State& state, oc::Effector::Effect effect) {
+        float selected = state.range(1) / 100.0f;
+        std::vector<oc::Mesh> scan = oc::BenchmarkScan::Generate((int) state.range(0), selected, 2048);
+        std::vector<oc::Mesh> model;
+        oc::Effector effector;
+        oc::BenchmarkMemory::Start();
+        for (auto _ : state) {
+            oc::BenchmarkMemory::Pause(state);
+            model = scan;
+            scan[0].image->SetTexture(1);
+            effector.Clear();
+            oc::Image::TexturesToDelete();
+            oc::BenchmarkMemory::Resume(state);
+            effector.ApplyEffect(model, effect, 64, 1);
+        }
+        oc::BenchmarkScan::Destroy(scan);
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+        oc::BenchmarkMemory::Report(state);
+    }
+}
+
+BENCHMARK(RasterizerVertices)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMillisecond);
+BENCHMARK(RasterizerUVS)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(SelectorOperation, Rect, RECT)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(SelectorOperation, Object, OBJECT)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(SelectorOperation, Triangle, TRIANGLE)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(SelectorOperation, Increase, INCREASE)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(SelectorOperation, Decrease, DECREASE)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(SelectorOperation, Complete, COMPLETE)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(EffectorEffect, Contrast, oc::Effector::CONTRAST)->RangeMultiplier(10)->Ranges({{1000, 100000}, {25, 25}})->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(EffectorEffect, Saturation, oc::Effector::SATURATION)->RangeMultiplier(10)->Ranges({{1000, 100000}, {25, 25}})->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(EffectorEffect, Tone, oc::Effector::TONE)->RangeMultiplier(10)->Ranges({{1000, 100000}, {25, 25}})->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(EffectorEffect, Move, oc::Effector::MOVE)->RangeMultiplier(10)->Ranges({{1000, 1000000}, {25, 25}})->Args({1000000, 100})->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(EffectorEffect, Clone, oc::Effector::CLONE)->RangeMultiplier(10)->Ranges({{1000, 1000000}, {25, 25}})->Args({1000000, 100})->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(EffectorEffect, Delete, oc::Effector::DELETE)->RangeMultiplier(10)->Ranges({{1000, 1000000}, {25, 25}})->Args({1000000, 100})->Unit(benchmark::kMillisecond);
@@ -0,0 +1,44 @@
+#include "benchmark/memory.h"
+#include "benchmark/scan.h"
+#include "data/file3d.h"
+
+namespace {
+    //the texture is written once, OBJ files only refer to it
+    std::string WriteScan(std::vector<oc::Mesh>& scan, std::string ext) {
+        std::string path = oc::BenchmarkScan::GetPath("scan." + ext);
+        if (ext == "obj")
+            scan[0].image->Write(scan[0].image->GetName());
+        oc::File3d(path, true).WriteModel(scan);
+        return path;
+    }
+
+    void File3dRead(benchmark::State& state, std::string ext) {
+        std::vector<oc::Mesh> scan = oc::BenchmarkScan::Generate((int) state.range(0), 0, 256);
+        std::string path = WriteScan(scan, ext);
+        oc::BenchmarkScan::Destroy(scan);
+        oc::BenchmarkMemory::Start();
+        for (auto _ : state) {
+            std::vector<oc::Mesh> model;
+            oc::File3d(path, false).ReadModel(oc::BenchmarkScan::kSubdivision, model);
+            benchmark::DoNotOptimize(model.data());
+            oc::BenchmarkScan::Destroy(model);
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+        oc::BenchmarkMemory::Report(state);
+    }
+
+    void File3dWrite(benchmark::State& state, std::string ext) {
+        std::vector<oc::Mesh> scan = oc::BenchmarkScan::Generate((int) state.range(0), 0, 256);
+        oc::BenchmarkMemory::Start();
+        for (auto _ : state)
+            WriteScan(scan, ext);
+        oc::BenchmarkScan::Destroy(scan);
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+        oc::BenchmarkMemory::Report(state);
+    }
+}
+
+BENCHMARK_CAPTURE(File3dRead, OBJ, "obj")->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(File3dRead, PLY, "ply")->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(File3dWrite, OBJ, "obj")->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(File3dWrite, PLY, "ply")->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond);
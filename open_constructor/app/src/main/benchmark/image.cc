@@ -0,0 +1,150 @@
+#include <memory>
+#include <random>
+#include "benchmark/memory.h"
+#include "benchmark/scan.h"
+#include "data/etc1.h"
+
+namespace {
+    //smooth noisy texture encoded into ETC1 has to stay within this error per channel
+    const double kETC1MaxRMSE = 8.0;
+
+    void ImageRead(benchmark::State& state, std::string ext) {
+        int size = (int) state.range(0);
+        std::string path = oc::BenchmarkScan::GetPath("image." + ext);
+        std::unique_ptr<oc::Image> source(oc::BenchmarkScan::GenerateImage(size, size));
+        source->Write(path);
+        oc::BenchmarkMemory::Start();
+        for (auto _ : state) {
+            oc::Image image(path);
+            benchmark::DoNotOptimize(image.GetData());
+        }
+        state.SetItemsProcessed(state.iterations() * size * size);
+        oc::BenchmarkMemory::Report(state);
+    }
+
+    void ImageWrite(benchmark::State& state, std::string ext) {
+        int size = (int) state.range(0);
+        std::string path = oc::BenchmarkScan::GetPath("image." + ext);
+        std::unique_ptr<oc::Image> image(oc::BenchmarkScan::GenerateImage(size, size));
+        oc::BenchmarkMemory::Start();
+        for (auto _ : state)
+            image->Write(path);
+        state.SetItemsProcessed(state.iterations() * size * size);
+        oc::BenchmarkMemory::Report(state);
+    }
+
+    void ImageETC1(benchmark::State& state) {
+        //gradients without the wrapping of the generated scan texture, ETC1 cannot represent hard edges
+        int size = (int) state.range(0);
+        std::mt19937 random(1234);
+        std::unique_ptr<oc::Image> image(new oc::Image(size, size));
+        for (int y = 0; y < size; y++) {
+            for (int x = 0; x < size; x++) {
+                unsigned char* texel = image->GetData() + (y * size + x) * 3;
+                int noise = (int) (random() % 32);
+                texel[0] = (unsigned char) (x * 224 / size + noise);
+                texel[1] = (unsigned char) (y * 224 / size + noise);
+                texel[2] = (unsigned char) (128 + noise);
+            }
+        }
+        std::vector<unsigned char> etc;
+        oc::BenchmarkMemory::Start();
+        for (auto _ : state) {
+            etc = oc::ETC1::Encode(image->GetData(), size, size);
+            benchmark::DoNotOptimize(etc.data());
+        }
+        state.SetItemsProcessed(state.iterations() * size * size);
+        oc::BenchmarkMemory::Report(state);
+
+        //round trip has to match the size and stay close to the source
+        if (etc.size() != oc::ETC1::Size(size, size)) {
+            state.SkipWithError("ETC1 data have wrong size");
+            return;
+        }
+        unsigned long count = (unsigned long) (size * size * 3);
+        std::vector<unsigned char> decoded(count);
+        oc::ETC1::Decode(etc.data(), size, size, decoded.data());
+        double sum = 0;
+        int max = 0;
+        for (unsigned long i = 0; i < count; i++) {
+            int diff = glm::abs((int) decoded[i] - (int) image->GetData()[i]);
+            sum += diff * diff;
+            max = glm::max(max, diff);
+        }
+        double rmse = glm::sqrt(sum / (double) count);
+        state.counters["RMSE"] = rmse;
+        state.counters["MaxError"] = max;
+        if (rmse > kETC1MaxRMSE)
+            state.SkipWithError("ETC1 error exceeds the bound");
+    }
+
+    //YUV conversions always work with frames of the color camera
+    void ImageExtractYUV(benchmark::State& state) {
+        int w = oc::BenchmarkScan::kCameraWidth;
+        int h = oc::BenchmarkScan::kCameraHeight;
+        std::unique_ptr<oc::Image> image(oc::BenchmarkScan::GenerateImage(w, h));
+        oc::BenchmarkMemory::Start();
+        for (auto _ : state) {
+            unsigned char* yuv = image->ExtractYUV(1);
+            benchmark::DoNotOptimize(yuv);
+            delete[] yuv;
+        }
+        state.SetItemsProcessed(state.iterations() * w * h);
+        oc::BenchmarkMemory::Report(state);
+    }
+
+    void ImageUpdateYUV(benchmark::State& state) {
+        int w = oc::BenchmarkScan::kCameraWidth;
+        int h = oc::BenchmarkScan::kCameraHeight;
+        std::unique_ptr<oc::Image> image(oc::BenchmarkScan::GenerateImage(w, h));
+        unsigned char* yuv = image->ExtractYUV(1);
+        oc::BenchmarkMemory::Start();
+        for (auto _ : state)
+            image->UpdateYUV(yuv, w, h, 1);
+        delete[] yuv;
+        state.SetItemsProcessed(state.iterations() * w * h);
+        oc::BenchmarkMemory::Report(state);
+    }
+
+    void ImageJPG2YUV(benchmark::State& state) {
+        int w = oc::BenchmarkScan::kCameraWidth;
+        int h = oc::BenchmarkScan::kCameraHeight;
+        std::string path = oc::BenchmarkScan::GetPath("yuv.jpg");
+        std::unique_ptr<oc::Image> image(oc::BenchmarkScan::GenerateImage(w, h));
+        unsigned char* yuv = image->ExtractYUV(1);
+        oc::Image::YUV2JPG(yuv, w, h, path);
+        delete[] yuv;
+        //decoder needs the same buffer size as texturizing has
+        yuv = new unsigned char[w * h * 3];
+        oc::BenchmarkMemory::Start();
+        for (auto _ : state)
+            oc::Image::JPG2YUV(path, yuv, w, h);
+        delete[] yuv;
+        state.SetItemsProcessed(state.iterations() * w * h);
+        oc::BenchmarkMemory::Report(state);
+    }
+
+    void ImageYUV2JPG(benchmark::State& state) {
+        int w = oc::BenchmarkScan::kCameraWidth;
+        int h = oc::BenchmarkScan::kCameraHeight;
+        std::string path = oc::BenchmarkScan::GetPath("yuv.jpg");
+        std::unique_ptr<oc::Image> image(oc::BenchmarkScan::GenerateImage(w, h));
+        unsigned char* yuv = image->ExtractYUV(1);
+        oc::BenchmarkMemory::Start();
+        for (auto _ : state)
+            oc::Image::YUV2JPG(yuv, w, h, path);
+        delete[] yuv;
+        state.SetItemsProcessed(state.iterations() * w * h);
+        oc::BenchmarkMemory::Report(state);
+    }
+}
+
+BENCHMARK_CAPTURE(ImageRead, JPG, "jpg")->RangeMultiplier(2)->Range(512, 2048)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(ImageRead, PNG, "png")->RangeMultiplier(2)->Range(512, 2048)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(ImageWrite, JPG, "jpg")->RangeMultiplier(2)->Range(512, 2048)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(ImageWrite, PNG, "png")->RangeMultiplier(2)->Range(512, 2048)->Unit(benchmark::kMillisecond);
+BENCHMARK(ImageETC1)->Arg(30)->RangeMultiplier(2)->Range(512, 2048)->Unit(benchmark::kMillisecond);
+BENCHMARK(ImageExtractYUV)->Unit(benchmark::kMillisecond);
+BENCHMARK(ImageUpdateYUV)->Unit(benchmark::kMillisecond);
+BENCHMARK(ImageJPG2YUV)->Unit(benchmark::kMillisecond);
+BENCHMARK(ImageYUV2JPG)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,71 @@
+#include <atomic>
+#include <cstdlib>
+#include <malloc.h>
+#include <new>
+#include <sys/resource.h>
+#include "benchmark/memory.h"
+
+namespace {
+    std::atomic<bool> memory_counting(false);
+    std::atomic<long> memory_allocs(0);
+    std::atomic<long> memory_used(0);
+    std::atomic<long> memory_peak(0);
+    long memory_base = 0;
+
+    void* Allocate(size_t size) {
+        void* p = malloc(size ? size : 1);
+        if (!p)
+            throw std::bad_alloc();
+        long used = memory_used += (long) malloc_usable_size(p);
+        if (memory_counting)
+            memory_allocs++;
+        //peak is updated only when it grows
+        long peak = memory_peak;
+        while ((used > peak) && !memory_peak.compare_exchange_weak(peak, used));
+        return p;
+    }
+
+    void Release(void* p) {
+        if (!p)
+            return;
+        memory_used -= (long) malloc_usable_size(p);
+        free(p);
+    }
+}
+
+//every C++ allocation of the benchmark binary is tracked
+void* operator new(size_t size) { return Allocate(size); }
+void* operator new[](size_t size) { return Allocate(size); }
+void operator delete(void* p) noexcept { Release(p); }
+void operator delete[](void* p) noexcept { Release(p); }
+void operator delete(void* p, size_t) noexcept { Release(p); }
+void operator delete[](void* p, size_t) noexcept { Release(p); }
+
+namespace oc {
+
+    void BenchmarkMemory::Start() {
+        memory_allocs = 0;
+        memory_base = memory_used;
+        memory_peak = memory_base;
+        memory_counting = true;
+    }
+
+    void BenchmarkMemory::Pause(benchmark::State& state) {
+        state.PauseTiming();
+        memory_counting = false;
+    }
+
+    void BenchmarkMemory::Resume(benchmark::State& state) {
+        memory_counting = true;
+        state.ResumeTiming();
+    }
+
+    void BenchmarkMemory::Report(benchmark::State& state) {
+        memory_counting = false;
+        struct rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        state.counters["allocs"] = benchmark::Counter((double) memory_allocs, benchmark::Counter::kAvgIterations);
+        state.counters["heap_MB"] = (memory_peak - memory_base) / 1048576.0;
+        state.counters["rss_MB"] = usage.ru_maxrss / 1024.0;
+    }
+}
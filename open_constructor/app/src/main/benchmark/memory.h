@@ -0,0 +1,36 @@
+#ifndef BENCHMARK_MEMORY_H
+#define BENCHMARK_MEMORY_H
+
+#include <benchmark/benchmark.h>
+
+namespace oc {
+
+    class BenchmarkMemory {
+    public:
+        /**
+         * Resets allocation counters, it is called right before the measured loop
+         */
+        static void Start();
+
+        /**
+         * Pauses timing and allocation counting while an iteration is being prepared
+         * @param state is state of running benchmark
+         */
+        static void Pause(benchmark::State& state);
+
+        /**
+         * Resumes timing and allocation counting
+         * @param state is state of running benchmark
+         */
+        static void Resume(benchmark::State& state);
+
+        /**
+         * Adds allocations per iteration, peak heap growth since Start and peak RSS of the process
+         * as counters of the benchmark
+         * @param state is state of finished benchmark
+         */
+        static void Report(benchmark::State& state);
+    };
+}
+
+#endif
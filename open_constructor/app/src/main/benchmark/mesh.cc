@@ -0,0 +1,23 @@
+#include <random>
+#include "benchmark/memory.h"
+#include "benchmark/scan.h"
+
+namespace {
+    void MeshGetFloorLevel(benchmark::State& state) {
+        std::vector<oc::Mesh> scan = oc::BenchmarkScan::Generate((int) state.range(0), 0, 16);
+        std::mt19937 random(1234);
+        std::uniform_real_distribution<float> position(-1.0f, 1.0f);
+        oc::BenchmarkMemory::Start();
+        for (auto _ : state) {
+            glm::vec3 p(position(random), 1.0f, position(random));
+            float level = INT_MIN;
+            for (oc::Mesh& m : scan)
+                level = glm::max(level, m.GetFloorLevel(p));
+            benchmark::DoNotOptimize(level);
+        }
+        oc::BenchmarkScan::Destroy(scan);
+        oc::BenchmarkMemory::Report(state);
+    }
+}
+
+BENCHMARK(MeshGetFloorLevel)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,83 @@
+#include <cstdlib>
+#include <random>
+#include "benchmark/scan.h"
+#include "editor/selector.h"
+
+namespace oc {
+
+    std::vector<Mesh> BenchmarkScan::Generate(int triangles, float selected, int textureSize) {
+        Image* image = GenerateImage(textureSize, textureSize);
+        image->SetName(GetPath("scan.png"));
+
+        //grid of quads, every quad is two triangles
+        int cells = glm::max(1, (int) glm::sqrt(triangles / 2.0f));
+        std::mt19937 random(1234);
+        std::uniform_real_distribution<float> height(-0.01f, 0.01f);
+        std::vector<float> heights((unsigned long) ((cells + 1) * (cells + 1)));
+        for (float& h : heights)
+            h = height(random);
+        float radius = glm::sqrt(selected);
+        std::vector<Mesh> output;
+        for (int z = 0; z < cells; z++) {
+            for (int x = 0; x < cells; x++) {
+                if (output.empty() || (output.back().vertices.size() >= kSubdivision * 3)) {
+                    output.push_back(Mesh());
+                    output.back().image = image;
+                    output.back().imageOwner = output.size() == 1;
+                }
+                Mesh& m = output.back();
+                glm::vec2 a((float) x / (float) cells, (float) z / (float) cells);
+                glm::vec2 b((float) (x + 1) / (float) cells, (float) (z + 1) / (float) cells);
+                glm::vec2 centre = (a + b) * 0.5f - 0.5f;
+                bool inside = glm::max(glm::abs(centre.x), glm::abs(centre.y)) * 2.0f < radius;
+                int corners[6][2] = {{0, 0}, {1, 0}, {1, 1}, {0, 0}, {1, 1}, {0, 1}};
+                for (int k = 0; k < 6; k++) {
+                    int cx = x + corners[k][0];
+                    int cz = z + corners[k][1];
+                    glm::vec2 uv((float) cx / (float) cells, (float) cz / (float) cells);
+                    m.vertices.push_back(glm::vec3(uv.x * 2.0f - 1.0f, heights[cz * (cells + 1) + cx],
+                                                   uv.y * 2.0f - 1.0f));
+                    m.normals.push_back(glm::vec3(0, 1, 0));
+                    m.uv.push_back(uv);
+                    m.colors.push_back(inside ? 0 : DESELECT_COLOR);
+                }
+            }
+        }
+        return output;
+    }
+
+    Image* BenchmarkScan::GenerateImage(int w, int h) {
+        std::mt19937 random(1234);
+        Image* image = new Image(w, h);
+        unsigned char* data = image->GetData();
+        for (int y = 0; y < h; y++) {
+            for (int x = 0; x < w; x++) {
+                unsigned char* texel = data + (y * w + x) * 3;
+                int noise = (int) (random() % 32);
+                texel[0] = (unsigned char) ((x * 255 / w + noise) & 255);
+                texel[1] = (unsigned char) ((y * 255 / h + noise) & 255);
+                texel[2] = (unsigned char) (128 + noise);
+            }
+        }
+        return image;
+    }
+
+    void BenchmarkScan::Destroy(std::vector<Mesh>& meshes) {
+        for (Mesh& m : meshes)
+            m.Destroy();
+        meshes.clear();
+        Image::TexturesToDelete();
+    }
+
+    glm::mat4 BenchmarkScan::GetWorld2Screen() {
+        float aspect = (float) kScreenWidth / (float) kScreenHeight;
+        glm::mat4 projection = glm::perspective(glm::radians(60.0f), aspect, 0.1f, 100.0f);
+        glm::mat4 view = glm::lookAt(glm::vec3(0, 1.5f, 1.5f), glm::vec3(0, 0, 0), glm::vec3(0, 1, 0));
+        return projection * view;
+    }
+
+    std::string BenchmarkScan::GetPath(std::string name) {
+        const char* tmp = getenv("TMPDIR");
+        return std::string(tmp ? tmp : "/tmp") + "/oc_benchmark_" + name;
+    }
+}
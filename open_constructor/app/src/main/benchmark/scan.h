@@ -0,0 +1,53 @@
+#ifndef BENCHMARK_SCAN_H
+#define BENCHMARK_SCAN_H
+
+#include <string>
+#include <vector>
+#include "data/mesh.h"
+
+namespace oc {
+
+    class BenchmarkScan {
+    public:
+        /**
+         * Generates terrain-like textured scan lying in XZ plane inside [-1, 1]
+         * @param triangles is approximate count of triangles
+         * @param selected is fraction of triangles marked as selected, the centre of the scan is selected first
+         * @param textureSize is width and height of the texture shared by all submeshes
+         * @return submeshes of at most kSubdivision triangles, the first one owns the texture
+         */
+        static std::vector<Mesh> Generate(int triangles, float selected, int textureSize = 1024);
+
+        /**
+         * Generates texture with a gradient and noise, it compresses like a photo, not like a flat color
+         * @param w is width in texels
+         * @param h is height in texels
+         * @return new image
+         */
+        static Image* GenerateImage(int w, int h);
+
+        /**
+         * Releases textures of generated scan
+         * @param meshes is scan to be released
+         */
+        static void Destroy(std::vector<Mesh>& meshes);
+
+        /**
+         * @return world to screen matrix of a camera looking at the scan from above
+         */
+        static glm::mat4 GetWorld2Screen();
+
+        /**
+         * @return path of a file in temporary directory of the benchmarks
+         */
+        static std::string GetPath(std::string name);
+
+        static const int kSubdivision = 20000;  ///< Triangles per submesh, the same as the app uses
+        static const int kScreenWidth = 1280;   ///< Width of the screen used for selecting
+        static const int kScreenHeight = 720;   ///< Height of the screen used for selecting
+        static const int kCameraWidth = 1280;   ///< Width of color camera frames
+        static const int kCameraHeight = 720;   ///< Height of color camera frames
+    };
+}
+
+#endif
@@ -0,0 +1,22 @@
+#ifndef HOST_ANDROID_LOG_H
+#define HOST_ANDROID_LOG_H
+
+#include <cstdio>
+
+//host replacement of Android logging, errors are printed to stderr, info only with HOST_LOG_INFO defined
+enum {
+    ANDROID_LOG_INFO = 4,
+    ANDROID_LOG_ERROR = 6
+};
+
+#ifdef HOST_LOG_INFO
+#define HOST_LOG_PRIORITY ANDROID_LOG_INFO
+#else
+#define HOST_LOG_PRIORITY ANDROID_LOG_ERROR
+#endif
+
+#define __android_log_print(priority, tag, ...) \
+  ((priority) >= HOST_LOG_PRIORITY ? \
+   (fprintf(stderr, "%s: ", tag), fprintf(stderr, __VA_ARGS__), fputc('\n', stderr)) : 0)
+
+#endif
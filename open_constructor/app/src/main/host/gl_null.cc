@@ -0,0 +1,104 @@
+#include <atomic>
+#include "gl/opengl.h"
+
+//null GL backend for host builds, it accepts every call and draws nothing
+
+namespace {
+    std::atomic<GLuint> gl_null_name(1);
+
+    void Generate(GLsizei n, GLuint* names) {
+        for (GLsizei i = 0; i < n; i++)
+            names[i] = gl_null_name++;
+    }
+
+    void EmptyLog(GLsizei bufSize, GLsizei* length, GLchar* infoLog) {
+        if (length)
+            *length = 0;
+        if (infoLog && (bufSize > 0))
+            infoLog[0] = 0;
+    }
+}
+
+extern "C" {
+
+//objects get unique names, queries report success and no capabilities
+void glGenBuffers(GLsizei n, GLuint* buffers) { Generate(n, buffers); }
+void glGenFramebuffers(GLsizei n, GLuint* framebuffers) { Generate(n, framebuffers); }
+void glGenRenderbuffers(GLsizei n, GLuint* renderbuffers) { Generate(n, renderbuffers); }
+void glGenTextures(GLsizei n, GLuint* textures) { Generate(n, textures); }
+GLuint glCreateProgram() { return gl_null_name++; }
+GLuint glCreateShader(GLenum) { return gl_null_name++; }
+GLenum glCheckFramebufferStatus(GLenum) { return GL_FRAMEBUFFER_COMPLETE; }
+GLenum glGetError() { return GL_NO_ERROR; }
+GLint glGetAttribLocation(GLuint, const GLchar*) { return -1; }
+GLint glGetUniformLocation(GLuint, const GLchar*) { return -1; }
+void glGetProgramiv(GLuint, GLenum, GLint* params) { *params = GL_TRUE; }
+void glGetProgramInfoLog(GLuint, GLsizei bufSize, GLsizei* length, GLchar* infoLog) {
+    EmptyLog(bufSize, length, infoLog);
+}
+void glGetShaderInfoLog(GLuint, GLsizei bufSize, GLsizei* length, GLchar* infoLog) {
+    EmptyLog(bufSize, length, infoLog);
+}
+const GLubyte* glGetString(GLenum name) {
+    return (const GLubyte*) (name == GL_VERSION ? "OpenGL ES 2.0 null" : "");
+}
+void* glMapBufferRange(GLenum, GLintptr, GLsizeiptr, GLbitfield) { return 0; }
+GLboolean glUnmapBuffer(GLenum) { return GL_FALSE; }
+GLsync glFenceSync(GLenum, GLbitfield) { return (GLsync) (size_t) gl_null_name++; }
+GLenum glClientWaitSync(GLsync, GLbitfield, GLuint64) { return GL_ALREADY_SIGNALED; }
+
+//state changes and drawing
+void glActiveTexture(GLenum) {}
+void glAttachShader(GLuint, GLuint) {}
+void glBeginTransformFeedback(GLenum) {}
+void glBindBuffer(GLenum, GLuint) {}
+void glBindBufferBase(GLenum, GLuint, GLuint) {}
+void glBindFramebuffer(GLenum, GLuint) {}
+void glBindRenderbuffer(GLenum, GLuint) {}
+void glBindTexture(GLenum, GLuint) {}
+void glBufferData(GLenum, GLsizeiptr, const void*, GLenum) {}
+void glClear(GLbitfield) {}
+void glClearColor(GLfloat, GLfloat, GLfloat, GLfloat) {}
+void glClearStencil(GLint) {}
+void glCompileShader(GLuint) {}
+void glCompressedTexImage2D(GLenum, GLint, GLenum, GLsizei, GLsizei, GLint, GLsizei, const void*) {}
+void glCullFace(GLenum) {}
+void glDeleteBuffers(GLsizei, const GLuint*) {}
+void glDeleteFramebuffers(GLsizei, const GLuint*) {}
+void glDeleteProgram(GLuint) {}
+void glDeleteRenderbuffers(GLsizei, const GLuint*) {}
+void glDeleteShader(GLuint) {}
+void glDeleteSync(GLsync) {}
+void glDeleteTextures(GLsizei, const GLuint*) {}
+void glDepthMask(GLboolean) {}
+void glDetachShader(GLuint, GLuint) {}
+void glDisable(GLenum) {}
+void glDisableVertexAttribArray(GLuint) {}
+void glDrawArrays(GLenum, GLint, GLsizei) {}
+void glDrawElements(GLenum, GLsizei, GLenum, const void*) {}
+void glEnable(GLenum) {}
+void glEnableVertexAttribArray(GLuint) {}
+void glEndTransformFeedback() {}
+void glFlush() {}
+void glFramebufferRenderbuffer(GLenum, GLenum, GLenum, GLuint) {}
+void glFramebufferTexture2D(GLenum, GLenum, GLenum, GLuint, GLint) {}
+void glLinkProgram(GLuint) {}
+void glPixelStorei(GLenum, GLint) {}
+void glRenderbufferStorage(GLenum, GLenum, GLsizei, GLsizei) {}
+void glShaderSource(GLuint, GLsizei, const GLchar* const*, const GLint*) {}
+void glTexImage2D(GLenum, GLint, GLint, GLsizei, GLsizei, GLint, GLenum, GLenum, const void*) {}
+void glTexParameterf(GLenum, GLenum, GLfloat) {}
+void glTexParameteri(GLenum, GLenum, GLint) {}
+void glTransformFeedbackVaryings(GLuint, GLsizei, const GLchar* const*, GLenum) {}
+void glUniform1f(GLint, GLfloat) {}
+void glUniform1i(GLint, GLint) {}
+void glUniform3f(GLint, GLfloat, GLfloat, GLfloat) {}
+void glUniformMatrix3fv(GLint, GLsizei, GLboolean, const GLfloat*) {}
+void glUniformMatrix4fv(GLint, GLsizei, GLboolean, const GLfloat*) {}
+void glUseProgram(GLuint) {}
+void glValidateProgram(GLuint) {}
+void glVertexAttrib3f(GLuint, GLfloat, GLfloat, GLfloat) {}
+void glVertexAttribPointer(GLuint, GLint, GLenum, GLboolean, GLsizei, const void*) {}
+void glViewport(GLint, GLint, GLsizei, GLsizei) {}
+
+}
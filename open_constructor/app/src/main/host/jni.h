@@ -0,0 +1,28 @@
+#ifndef HOST_JNI_H
+#define HOST_JNI_H
+
+#include <cstdint>
+
+//host replacement of the JNI types used by the native interface, Java is never attached on host
+typedef uint8_t jboolean;
+typedef int8_t jbyte;
+typedef int32_t jint;
+typedef float jfloat;
+typedef double jdouble;
+
+class _jobject {};
+typedef _jobject* jobject;
+typedef jobject jstring;
+typedef jobject jbyteArray;
+
+struct JNIEnv {
+    const char* GetStringUTFChars(jstring, jboolean*) { return ""; }
+    void ReleaseStringUTFChars(jstring, const char*) {}
+    jbyteArray NewByteArray(jint) { return 0; }
+    void SetByteArrayRegion(jbyteArray, jint, jint, const jbyte*) {}
+};
+
+#define JNIEXPORT
+#define JNICALL
+
+#endif
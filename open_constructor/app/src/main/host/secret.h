@@ -0,0 +1,9 @@
+#ifndef HOST_SECRET_H
+#define HOST_SECRET_H
+
+#include <string>
+
+//host builds have no client secret
+inline std::string secret() { return "NO SECRET"; }
+
+#endif
@@ -0,0 +1,362 @@
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <tango_3d_reconstruction_api.h>
+#include <tango_client_api.h>
+#include <tango_support_api.h>
+#include "glm/glm.hpp"
+#include "glm/gtc/quaternion.hpp"
+
+//stand-in Tango backend for host builds, there is no tracking and the reconstruction only marks
+//occupied voxels and meshes their top faces, it is enough to measure the code around the library
+
+namespace {
+    const int kGridSize = 16;
+    const int kMaxPoints = 60000;
+
+    struct Cell {
+        int x, y, z;
+
+        bool operator==(const Cell& o) const { return (x == o.x) && (y == o.y) && (z == o.z); }
+    };
+
+    struct CellHasher {
+        size_t operator()(const Cell& c) const {
+            return ((size_t) c.x * 73856093) ^ ((size_t) c.y * 19349663) ^ ((size_t) c.z * 83492791);
+        }
+    };
+
+    int FloorDiv(int value, int divisor) {
+        return value >= 0 ? value / divisor : (value - divisor + 1) / divisor;
+    }
+
+    glm::quat Orientation(const Tango3DR_Pose* pose) {
+        return glm::quat((float) pose->orientation[3], (float) pose->orientation[0],
+                         (float) pose->orientation[1], (float) pose->orientation[2]);
+    }
+}
+
+struct _Tango3DR_Config {
+    double resolution;
+    double min_depth;
+    double max_depth;
+};
+
+struct _Tango3DR_ReconstructionContext {
+    double resolution;
+    double min_depth;
+    double max_depth;
+    std::mutex mutex;
+    std::unordered_map<Cell, std::vector<unsigned char>, CellHasher> grid; ///< Voxel weights by grid index
+};
+
+struct TangoSupportPointCloudManager {
+    std::mutex mutex;
+    TangoPointCloud cloud;
+    std::vector<float> points;
+};
+
+extern "C" {
+
+//Tango service
+TangoErrorType TangoService_setBinder(void*, void*) { return TANGO_SUCCESS; }
+TangoErrorType TangoService_connectOnPointCloudAvailable(void (*)(void*, const TangoPointCloud*), ...) {
+    return TANGO_SUCCESS;
+}
+TangoErrorType TangoService_connectOnFrameAvailable(TangoCameraId, void*,
+                                                    void (*)(void*, TangoCameraId, const TangoImageBuffer*)) {
+    return TANGO_SUCCESS;
+}
+TangoErrorType TangoService_connectOnTangoEvent(void (*)(void*, const TangoEvent*), ...) { return TANGO_SUCCESS; }
+TangoErrorType TangoService_connect(void*, TangoConfig) { return TANGO_SUCCESS; }
+void TangoService_disconnect() {}
+TangoErrorType TangoService_getPoseAtTime(double, TangoCoordinateFramePair, TangoPoseData* pose) {
+    memset(pose, 0, sizeof(TangoPoseData));
+    pose->status_code = TANGO_POSE_INVALID;
+    return TANGO_SUCCESS;
+}
+TangoErrorType TangoService_getCameraIntrinsics(TangoCameraId camera_id, TangoCameraIntrinsics* intrinsics) {
+    memset(intrinsics, 0, sizeof(TangoCameraIntrinsics));
+    intrinsics->camera_id = camera_id;
+    intrinsics->calibration_type = TANGO_CALIBRATION_POLYNOMIAL_3_PARAMETERS;
+    intrinsics->width = camera_id == TANGO_CAMERA_DEPTH ? 224 : 1280;
+    intrinsics->height = camera_id == TANGO_CAMERA_DEPTH ? 172 : 720;
+    intrinsics->fx = intrinsics->fy = intrinsics->width * 0.8;
+    intrinsics->cx = intrinsics->width * 0.5;
+    intrinsics->cy = intrinsics->height * 0.5;
+    return TANGO_SUCCESS;
+}
+TangoConfig TangoService_getConfig(TangoConfigType) { return malloc(1); }
+void TangoConfig_free(TangoConfig config) { free(config); }
+TangoErrorType TangoConfig_setBool(TangoConfig, const char*, bool) { return TANGO_SUCCESS; }
+TangoErrorType TangoConfig_setInt32(TangoConfig, const char*, int32_t) { return TANGO_SUCCESS; }
+TangoErrorType TangoConfig_setString(TangoConfig, const char*, const char*) { return TANGO_SUCCESS; }
+TangoErrorType TangoConfig_getInt32(TangoConfig, const char*, int32_t* value) {
+    *value = kMaxPoints;
+    return TANGO_SUCCESS;
+}
+
+//Tango support, there is no live tracking
+void TangoSupport_initialize(TangoSupport_GetPoseAtTimeFn, TangoSupport_GetCameraIntrinsicsFn) {}
+TangoErrorType TangoSupport_getMatrixTransformAtTime(double timestamp, TangoCoordinateFrameType,
+                                                     TangoCoordinateFrameType, TangoSupportEngineType,
+                                                     TangoSupportEngineType, TangoSupportRotation,
+                                                     TangoMatrixTransformData* matrix_transform) {
+    memset(matrix_transform, 0, sizeof(TangoMatrixTransformData));
+    matrix_transform->timestamp = timestamp;
+    matrix_transform->status_code = TANGO_POSE_INVALID;
+    return TANGO_SUCCESS;
+}
+TangoErrorType TangoSupport_createPointCloudManager(size_t max_points, TangoSupportPointCloudManager** manager) {
+    *manager = new TangoSupportPointCloudManager();
+    (*manager)->points.resize(max_points * 4);
+    memset(&(*manager)->cloud, 0, sizeof(TangoPointCloud));
+    (*manager)->cloud.points = (float (*)[4]) (*manager)->points.data();
+    return TANGO_SUCCESS;
+}
+TangoErrorType TangoSupport_freePointCloudManager(TangoSupportPointCloudManager* manager) {
+    delete manager;
+    return TANGO_SUCCESS;
+}
+TangoErrorType TangoSupport_updatePointCloud(TangoSupportPointCloudManager* manager,
+                                             const TangoPointCloud* point_cloud) {
+    std::lock_guard<std::mutex> lock(manager->mutex);
+    uint32_t count = std::min(point_cloud->num_points, (uint32_t) (manager->points.size() / 4));
+    memcpy(manager->points.data(), point_cloud->points, count * sizeof(float) * 4);
+    manager->cloud.timestamp = point_cloud->timestamp;
+    manager->cloud.num_points = count;
+    return TANGO_SUCCESS;
+}
+TangoErrorType TangoSupport_getLatestPointCloud(TangoSupportPointCloudManager* manager,
+                                                TangoPointCloud** latest_point_cloud) {
+    *latest_point_cloud = &manager->cloud;
+    return TANGO_SUCCESS;
+}
+
+//Tango 3D reconstruction
+Tango3DR_Config Tango3DR_Config_create(Tango3DR_ConfigType) {
+    Tango3DR_Config config = new _Tango3DR_Config();
+    config->resolution = 0.01;
+    config->min_depth = 0;
+    config->max_depth = 3.5;
+    return config;
+}
+Tango3DR_Status Tango3DR_Config_destroy(Tango3DR_Config config) {
+    delete config;
+    return TANGO_3DR_SUCCESS;
+}
+Tango3DR_Status Tango3DR_Config_setBool(Tango3DR_Config, const char*, bool) { return TANGO_3DR_SUCCESS; }
+Tango3DR_Status Tango3DR_Config_setInt32(Tango3DR_Config, const char*, int32_t) { return TANGO_3DR_SUCCESS; }
+Tango3DR_Status Tango3DR_Config_setDouble(Tango3DR_Config config, const char* key, double value) {
+    std::string name = key;
+    if (name == "resolution")
+        config->resolution = value;
+    else if (name == "min_depth")
+        config->min_depth = value;
+    else if (name == "max_depth")
+        config->max_depth = value;
+    return TANGO_3DR_SUCCESS;
+}
+
+Tango3DR_ReconstructionContext Tango3DR_ReconstructionContext_create(const Tango3DR_Config context_config) {
+    Tango3DR_ReconstructionContext context = new _Tango3DR_ReconstructionContext();
+    context->resolution = context_config->resolution;
+    context->min_depth = context_config->min_depth;
+    context->max_depth = context_config->max_depth;
+    return context;
+}
+Tango3DR_Status Tango3DR_ReconstructionContext_destroy(Tango3DR_ReconstructionContext context) {
+    delete context;
+    return TANGO_3DR_SUCCESS;
+}
+Tango3DR_Status Tango3DR_ReconstructionContext_setColorCalibration(const Tango3DR_ReconstructionContext,
+                                                                   const Tango3DR_CameraCalibration*) {
+    return TANGO_3DR_SUCCESS;
+}
+Tango3DR_Status Tango3DR_ReconstructionContext_setDepthCalibration(const Tango3DR_ReconstructionContext,
+                                                                   const Tango3DR_CameraCalibration*) {
+    return TANGO_3DR_SUCCESS;
+}
+Tango3DR_Status Tango3DR_clear(Tango3DR_ReconstructionContext context) {
+    std::lock_guard<std::mutex> lock(context->mutex);
+    context->grid.clear();
+    return TANGO_3DR_SUCCESS;
+}
+
+Tango3DR_Status Tango3DR_update(Tango3DR_ReconstructionContext context, const Tango3DR_PointCloud* cloud,
+                                const Tango3DR_Pose* cloud_pose, const Tango3DR_ImageBuffer*,
+                                const Tango3DR_Pose*, Tango3DR_GridIndexArray* updated_indices) {
+    if (!context || !cloud || !cloud_pose || !updated_indices)
+        return TANGO_3DR_INVALID;
+
+    //accumulate weights of voxels hit by depth points
+    glm::quat rotation = Orientation(cloud_pose);
+    glm::vec3 translation((float) cloud_pose->translation[0], (float) cloud_pose->translation[1],
+                          (float) cloud_pose->translation[2]);
+    std::unordered_set<Cell, CellHasher> updated;
+    std::lock_guard<std::mutex> lock(context->mutex);
+    for (uint32_t i = 0; i < cloud->num_points; i++) {
+        glm::vec3 p(cloud->points[i][0], cloud->points[i][1], cloud->points[i][2]);
+        if ((p.z < context->min_depth) || (p.z > context->max_depth))
+            continue;
+        glm::vec3 w = rotation * p + translation;
+        int vx = (int) glm::floor(w.x / context->resolution);
+        int vy = (int) glm::floor(w.y / context->resolution);
+        int vz = (int) glm::floor(w.z / context->resolution);
+        Cell cell = {FloorDiv(vx, kGridSize), FloorDiv(vy, kGridSize), FloorDiv(vz, kGridSize)};
+        std::vector<unsigned char>& voxels = context->grid[cell];
+        if (voxels.empty())
+            voxels.resize(kGridSize * kGridSize * kGridSize, 0);
+        int index = ((vz - cell.z * kGridSize) * kGridSize + (vy - cell.y * kGridSize)) * kGridSize +
+                    (vx - cell.x * kGridSize);
+        if (voxels[index] < 255)
+            voxels[index]++;
+        updated.insert(cell);
+    }
+
+    updated_indices->num_indices = (uint32_t) updated.size();
+    updated_indices->indices = (Tango3DR_GridIndex*) malloc(updated.size() * sizeof(Tango3DR_GridIndex));
+    uint32_t i = 0;
+    for (const Cell& c : updated) {
+        updated_indices->indices[i][0] = c.x;
+        updated_indices->indices[i][1] = c.y;
+        updated_indices->indices[i][2] = c.z;
+        i++;
+    }
+    return TANGO_3DR_SUCCESS;
+}
+
+Tango3DR_Status Tango3DR_GridIndexArray_destroy(Tango3DR_GridIndexArray* grid_index_array) {
+    free(grid_index_array->indices);
+    grid_index_array->indices = 0;
+    grid_index_array->num_indices = 0;
+    return TANGO_3DR_SUCCESS;
+}
+
+static Tango3DR_Status ExtractSegment(const Tango3DR_ReconstructionContext context,
+                                      const Tango3DR_GridIndex grid_index, Tango3DR_Mesh* mesh, bool preallocated) {
+    if (!context || !mesh)
+        return TANGO_3DR_INVALID;
+    if (!preallocated)
+        memset(mesh, 0, sizeof(Tango3DR_Mesh));
+    mesh->num_vertices = 0;
+    mesh->num_faces = 0;
+
+    //the lock is held only to copy the voxels, segments can be extracted concurrently
+    Cell cell = {grid_index[0], grid_index[1], grid_index[2]};
+    std::vector<unsigned char> voxels;
+    {
+        std::lock_guard<std::mutex> lock(context->mutex);
+        auto it = context->grid.find(cell);
+        if (it == context->grid.end())
+            return TANGO_3DR_SUCCESS;
+        voxels = it->second;
+    }
+
+    //every voxel is a quad facing up, its color shows the weight
+    std::vector<int> occupied;
+    for (int i = 0; i < (int) voxels.size(); i++)
+        if (voxels[i])
+            occupied.push_back(i);
+    uint32_t count = (uint32_t) occupied.size();
+    if (preallocated) {
+        if (!mesh->colors || (count * 4 > mesh->max_num_vertices) || (count * 2 > mesh->max_num_faces))
+            return TANGO_3DR_INSUFFICIENT_SPACE;
+    } else {
+        mesh->vertices = (Tango3DR_Vector3*) malloc(count * 4 * sizeof(Tango3DR_Vector3));
+        mesh->colors = (Tango3DR_Color*) malloc(count * 4 * sizeof(Tango3DR_Color));
+        mesh->faces = (Tango3DR_Face*) malloc(count * 2 * sizeof(Tango3DR_Face));
+        mesh->max_num_vertices = count * 4;
+        mesh->max_num_faces = count * 2;
+    }
+    mesh->num_vertices = count * 4;
+    mesh->num_faces = count * 2;
+    float r = (float) context->resolution;
+    for (uint32_t i = 0; i < count; i++) {
+        int v = occupied[i];
+        float x = (cell.x * kGridSize + v % kGridSize) * r;
+        float y = (cell.y * kGridSize + (v / kGridSize) % kGridSize + 1) * r;
+        float z = (cell.z * kGridSize + v / (kGridSize * kGridSize)) * r;
+        float corners[4][3] = {{x, y, z}, {x + r, y, z}, {x + r, y, z + r}, {x, y, z + r}};
+        unsigned char weight = voxels[v];
+        for (int j = 0; j < 4; j++) {
+            memcpy(mesh->vertices[i * 4 + j], corners[j], sizeof(Tango3DR_Vector3));
+            mesh->colors[i * 4 + j][0] = weight;
+            mesh->colors[i * 4 + j][1] = weight;
+            mesh->colors[i * 4 + j][2] = weight;
+            mesh->colors[i * 4 + j][3] = 255;
+        }
+        uint32_t faces[2][3] = {{i * 4, i * 4 + 2, i * 4 + 1}, {i * 4, i * 4 + 3, i * 4 + 2}};
+        memcpy(mesh->faces[i * 2], faces, sizeof(faces));
+    }
+    return TANGO_3DR_SUCCESS;
+}
+
+Tango3DR_Status Tango3DR_extractMeshSegment(const Tango3DR_ReconstructionContext context,
+                                            const Tango3DR_GridIndex grid_index, Tango3DR_Mesh* mesh) {
+    return ExtractSegment(context, grid_index, mesh, false);
+}
+
+Tango3DR_Status Tango3DR_extractPreallocatedMeshSegment(const Tango3DR_ReconstructionContext context,
+                                                        const Tango3DR_GridIndex grid_index, Tango3DR_Mesh* mesh) {
+    return ExtractSegment(context, grid_index, mesh, true);
+}
+
+Tango3DR_Status Tango3DR_Mesh_init(const uint32_t vertices_capacity, const uint32_t faces_capacity,
+                                   const bool allocate_normals, const bool allocate_colors,
+                                   const bool allocate_tex_coords, const bool allocate_tex_ids,
+                                   const uint32_t, const uint32_t, const uint32_t, Tango3DR_Mesh* mesh) {
+    if (!mesh || allocate_tex_coords || allocate_tex_ids)
+        return TANGO_3DR_INVALID;
+    memset(mesh, 0, sizeof(Tango3DR_Mesh));
+    mesh->vertices = (Tango3DR_Vector3*) malloc(vertices_capacity * sizeof(Tango3DR_Vector3));
+    mesh->faces = (Tango3DR_Face*) malloc(faces_capacity * sizeof(Tango3DR_Face));
+    if (allocate_normals)
+        mesh->normals = (Tango3DR_Vector3*) malloc(vertices_capacity * sizeof(Tango3DR_Vector3));
+    if (allocate_colors)
+        mesh->colors = (Tango3DR_Color*) malloc(vertices_capacity * sizeof(Tango3DR_Color));
+    mesh->max_num_vertices = vertices_capacity;
+    mesh->max_num_faces = faces_capacity;
+    return TANGO_3DR_SUCCESS;
+}
+
+Tango3DR_Status Tango3DR_Mesh_destroy(Tango3DR_Mesh* mesh) {
+    free(mesh->vertices);
+    free(mesh->faces);
+    free(mesh->normals);
+    free(mesh->colors);
+    free(mesh->texture_coords);
+    free(mesh->texture_ids);
+    free(mesh->textures);
+    memset(mesh, 0, sizeof(Tango3DR_Mesh));
+    return TANGO_3DR_SUCCESS;
+}
+
+//texturing and full mesh export are not available in the stand-in
+Tango3DR_Status Tango3DR_extractFullMesh(const Tango3DR_ReconstructionContext, Tango3DR_Mesh*) {
+    return TANGO_3DR_ERROR;
+}
+Tango3DR_Status Tango3DR_Mesh_loadFromObj(const char* const, Tango3DR_Mesh*) { return TANGO_3DR_ERROR; }
+Tango3DR_Status Tango3DR_Mesh_saveToObj(const Tango3DR_Mesh*, const char* const) { return TANGO_3DR_ERROR; }
+Tango3DR_TexturingContext Tango3DR_TexturingContext_create(const Tango3DR_Config, const Tango3DR_Mesh*) {
+    return 0;
+}
+Tango3DR_Status Tango3DR_TexturingContext_destroy(Tango3DR_TexturingContext) { return TANGO_3DR_SUCCESS; }
+Tango3DR_Status Tango3DR_TexturingContext_setColorCalibration(const Tango3DR_TexturingContext,
+                                                              const Tango3DR_CameraCalibration*) {
+    return TANGO_3DR_ERROR;
+}
+Tango3DR_Status Tango3DR_updateTexture(Tango3DR_TexturingContext, const Tango3DR_ImageBuffer*,
+                                       const Tango3DR_Pose*) {
+    return TANGO_3DR_ERROR;
+}
+Tango3DR_Status Tango3DR_getTexturedMesh(const Tango3DR_TexturingContext, Tango3DR_Mesh*) {
+    return TANGO_3DR_ERROR;
+}
+
+}
@@ -32,9 +32,21 @@ public class TangoJNINative {
   // Called when the toggle button is clicked
   public static native void onToggleButtonClicked(boolean reconstructionRunning);
 
+  // Limit how often one scan segment is re-extracted and how many segments are extracted per update
+  public static native void setExtractionRate(float rate, int limit);
+
   // Called when the clear button is clicked
   public static native void onClearButtonClicked();
 
+  // Start capturing depth, color and poses into file
+  public static native void startRecording(String name);
+
+  // Stop capturing
+  public static native void stopRecording();
+
+  // Feed captured data through reconstruction, the report is available by getEvent
+  public static native void replay(String name, boolean realtime);
+
   // Load 3D model from file
   public static native void load(String name);
 
@@ -56,12 +68,30 @@ public class TangoJNINative {
   // Get Tango event
   public static native byte[] getEvent();
 
+  // Write trace of native stages in Chrome trace JSON format, needs native build with OC_TRACE
+  public static native boolean exportTrace(String name);
+
+  // Get duration percentiles of native stages
+  public static native byte[] getTraceStats();
+
+  // Get wait and hold times of native locks by call site
+  public static native byte[] getLockReport();
+
+  // Get hit rate and memory of the pooled scan meshes
+  public static native byte[] getMeshPoolStats();
+
   // Apply effect on model
   public static native void applyEffect(int effect, float value, int axis);
 
   // Preview effect on model
   public static native void previewEffect(int effect, float value, int axis);
 
+  // Redo the last undone edit
+  public static native void redo();
+
+  // Undo the last edit
+  public static native void undo();
+
   // Apply select on model
   public static native void applySelect(float x, float y, boolean triangle);
 
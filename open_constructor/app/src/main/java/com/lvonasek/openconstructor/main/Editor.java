@@ -132,6 +132,30 @@ public class Editor extends View implements Button.OnClickListener, View.OnTouch
     }).start();
   }
 
+  private void history(final boolean undo)
+  {
+    mProgress.setVisibility(View.VISIBLE);
+    new Thread(new Runnable()
+    {
+      @Override
+      public void run()
+      {
+        if (undo)
+          TangoJNINative.undo();
+        else
+          TangoJNINative.redo();
+        mContext.runOnUiThread(new Runnable()
+        {
+          @Override
+          public void run()
+          {
+            mProgress.setVisibility(View.INVISIBLE);
+          }
+        });
+      }
+    }).start();
+  }
+
   public boolean initialized() { return mInitialized; }
 
   public boolean movingLocked()
@@ -190,6 +214,10 @@ public class Editor extends View implements Button.OnClickListener, View.OnTouch
         setColorScreen();
       if (view.getId() == R.id.editor3)
         setTransformScreen();
+      if (view.getId() == R.id.editor4)
+        history(true);
+      if (view.getId() == R.id.editor5)
+        history(false);
       return;
     }
     //back button
@@ -507,6 +535,8 @@ public class Editor extends View implements Button.OnClickListener, View.OnTouch
     mButtons.get(1).setText(mContext.getString(R.string.editor_main_select));
     mButtons.get(2).setText(mContext.getString(R.string.editor_main_colors));
     mButtons.get(3).setText(mContext.getString(R.string.editor_main_transform));
+    mButtons.get(4).setText(mContext.getString(R.string.editor_main_undo));
+    mButtons.get(5).setText(mContext.getString(R.string.editor_main_redo));
     mScreen = Screen.MAIN;
   }
 
@@ -8,26 +8,47 @@ LOCAL_SHARED_LIBRARIES := tango_client_api tango_3d_reconstruction tango_support
 LOCAL_STATIC_LIBRARIES := jpeg-turbo png
 LOCAL_CFLAGS           := -std=c++11
 
+# Trace probes of the hot paths are enabled by ndk-build OC_TRACE=1
+ifeq ($(OC_TRACE),1)
+LOCAL_CFLAGS           += -DOC_TRACE
+endif
+
+# Mesh segments are extracted on all cores by ndk-build OC_PARALLEL_EXTRACTION=1, thread safety of 3DR is unverified
+ifeq ($(OC_PARALLEL_EXTRACTION),1)
+LOCAL_CFLAGS           += -DOC_PARALLEL_EXTRACTION
+endif
+
 LOCAL_C_INCLUDES := $(PROJECT_ROOT)/third_party/glm/ \
                     $(PROJECT_ROOT)/third_party/libjpeg-turbo/include/ \
                     $(PROJECT_ROOT)/third_party/libpng/include/
 
 LOCAL_SRC_FILES := app.cc \
                    scene.cc \
+                   data/atlas.cc \
+                   data/etc1.cc \
                    data/file3d.cc \
                    data/image.cc \
                    data/mesh.cc \
+                   data/mutex.cc \
+                   data/parallel.cc \
+                   data/trace.cc \
                    editor/effector.cc \
+                   editor/journal.cc \
                    editor/rasterizer.cc \
                    editor/selector.cc \
                    gl/camera.cc \
+                   gl/feedback.cc \
                    gl/glsl.cc \
                    gl/renderer.cc \
+                   gl/textures.cc \
+                   tango/integration.cc \
+                   tango/pool.cc \
+                   tango/replay.cc \
                    tango/scan.cc \
                    tango/service.cc \
                    tango/texturize.cc
 
-LOCAL_LDLIBS    := -llog -lGLESv2 -L$(SYSROOT)/usr/lib -lz -landroid
+LOCAL_LDLIBS    := -llog -lGLESv2 -lGLESv3 -L$(SYSROOT)/usr/lib -lz -landroid
 include $(BUILD_SHARED_LIBRARY)
 
 $(call import-add-path, $(PROJECT_ROOT))
@@ -1,8 +1,11 @@
+#include <algorithm>
+#include <cstring>
 #include <sstream>
 #include "app.h"
 
 namespace {
     const int kSubdivisionSize = 20000;
+    const int kIntegrationQueueSize = 2;
 
     void onPointCloudAvailableRouter(void *context, const TangoPointCloud *point_cloud) {
         oc::App *app = static_cast<oc::App *>(context);
@@ -28,6 +31,22 @@ namespace oc {
         event_mutex_.unlock();
     }
 
+    bool App::ExportTrace(std::string filename) {
+        return Trace::Export(filename);
+    }
+
+    std::string App::GetTraceStats() {
+        return Trace::GetStatsText();
+    }
+
+    std::string App::GetLockReport() {
+        return binder_mutex_.GetReport() + render_mutex_.GetReport() + callback_mutex_.GetReport();
+    }
+
+    std::string App::GetMeshPoolStats() {
+        return scan.GetPoolStats();
+    }
+
     std::string App::GetEvent() {
         event_mutex_.lock();
         std::string output = event_;
@@ -39,7 +58,7 @@ namespace oc {
     }
 
     void App::onPointCloudAvailable(TangoPointCloud *point_cloud) {
-        if (!t3dr_is_running_)
+        if (!t3dr_is_running_ || replay.IsReplaying())
             return;
 
         TangoMatrixTransformData matrix_transform;
@@ -47,18 +66,24 @@ namespace oc {
                 point_cloud->timestamp, TANGO_COORDINATE_FRAME_AREA_DESCRIPTION,
                 TANGO_COORDINATE_FRAME_CAMERA_DEPTH, TANGO_SUPPORT_ENGINE_OPENGL,
                 TANGO_SUPPORT_ENGINE_TANGO, ROTATION_0, &matrix_transform);
+        replay.AddPointCloud(point_cloud, matrix_transform);
+        ProcessPointCloud(point_cloud, matrix_transform);
+    }
+
+    void App::ProcessPointCloud(TangoPointCloud *point_cloud, TangoMatrixTransformData& matrix_transform) {
+        OC_TRACE_SCOPE("App::ProcessPointCloud");
         if (matrix_transform.status_code != TANGO_POSE_VALID)
             return;
 
-        binder_mutex_.lock();
+        callback_mutex_.lock(__func__);
         point_cloud_matrix_ = glm::make_mat4(matrix_transform.matrix);
         TangoSupport_updatePointCloud(tango.Pointcloud(), point_cloud);
         point_cloud_available_ = true;
-        binder_mutex_.unlock();
+        callback_mutex_.unlock();
     }
 
     void App::onFrameAvailable(TangoCameraId id, const TangoImageBuffer *buffer) {
-        if (id != TANGO_CAMERA_COLOR || !t3dr_is_running_)
+        if (id != TANGO_CAMERA_COLOR || !t3dr_is_running_ || replay.IsReplaying())
             return;
 
         TangoMatrixTransformData matrix_transform;
@@ -66,24 +91,22 @@ namespace oc {
                         buffer->timestamp, TANGO_COORDINATE_FRAME_AREA_DESCRIPTION,
                         TANGO_COORDINATE_FRAME_CAMERA_COLOR, TANGO_SUPPORT_ENGINE_OPENGL,
                         TANGO_SUPPORT_ENGINE_TANGO, ROTATION_0, &matrix_transform);
+        replay.AddFrame(buffer, matrix_transform);
+        ProcessFrame(buffer, matrix_transform);
+    }
+
+    bool App::ProcessFrame(const TangoImageBuffer *buffer, TangoMatrixTransformData& matrix_transform) {
+        OC_TRACE_SCOPE("App::ProcessFrame");
         if (matrix_transform.status_code != TANGO_POSE_VALID)
-            return;
+            return false;
 
-        binder_mutex_.lock();
+        callback_mutex_.lock(__func__);
         if (!point_cloud_available_) {
-            binder_mutex_.unlock();
-            return;
+            callback_mutex_.unlock();
+            return false;
         }
 
-        image_matrix = glm::make_mat4(matrix_transform.matrix);
-        Tango3DR_ImageBuffer t3dr_image;
-        t3dr_image.width = buffer->width;
-        t3dr_image.height = buffer->height;
-        t3dr_image.stride = buffer->stride;
-        t3dr_image.timestamp = buffer->timestamp;
-        t3dr_image.format = static_cast<Tango3DR_ImageFormatType>(buffer->format);
-        t3dr_image.data = buffer->data;
-
+        glm::mat4 image_matrix = glm::make_mat4(matrix_transform.matrix);
         Tango3DR_Pose t3dr_image_pose = GLCamera::Extract3DRPose(image_matrix);
         glm::quat rot = glm::quat((float) t3dr_image_pose.orientation[0],
                                   (float) t3dr_image_pose.orientation[1],
@@ -92,41 +115,103 @@ namespace oc {
         float diff = GLCamera::Diff(rot, image_rotation);
         image_rotation = rot;
         if (diff > 1) {
-            binder_mutex_.unlock();
-            return;
+            callback_mutex_.unlock();
+            return false;
         }
 
-        Tango3DR_PointCloud t3dr_depth;
+        //the callback only copies the data, integration runs on the worker thread
+        IntegrationTask* task = integration.Acquire();
+        if (!task) {
+            callback_mutex_.unlock();
+            return false;
+        }
         TangoSupport_getLatestPointCloud(tango.Pointcloud(), &front_cloud_);
-        t3dr_depth.timestamp = front_cloud_->timestamp;
-        t3dr_depth.num_points = front_cloud_->num_points;
-        t3dr_depth.points = front_cloud_->points;
+        task->points.assign(&front_cloud_->points[0][0], &front_cloud_->points[0][0] + front_cloud_->num_points * 4);
+        task->depth_timestamp = front_cloud_->timestamp;
+        task->depth_matrix = point_cloud_matrix_;
+        point_cloud_available_ = false;
+        callback_mutex_.unlock();
+
+        task->image.assign(buffer->data, buffer->data + buffer->stride * buffer->height * 3 / 2);
+        task->image_info.width = buffer->width;
+        task->image_info.height = buffer->height;
+        task->image_info.stride = buffer->stride;
+        task->image_info.timestamp = buffer->timestamp;
+        task->image_info.format = static_cast<Tango3DR_ImageFormatType>(buffer->format);
+        task->image_matrix = image_matrix;
+        integration.Push(task);
+        return true;
+    }
+
+    void App::Integrate(IntegrationTask& task) {
+        binder_mutex_.lock(__func__);
+        Tango3DR_PointCloud t3dr_depth;
+        t3dr_depth.timestamp = task.depth_timestamp;
+        t3dr_depth.num_points = (uint32_t) (task.points.size() / 4);
+        t3dr_depth.points = (Tango3DR_Vector4*) task.points.data();
+        task.image_info.data = task.image.data();
 
-        Tango3DR_Pose t3dr_depth_pose = GLCamera::Extract3DRPose(point_cloud_matrix_);
+        Tango3DR_Pose t3dr_depth_pose = GLCamera::Extract3DRPose(task.depth_matrix);
+        Tango3DR_Pose t3dr_image_pose = GLCamera::Extract3DRPose(task.image_matrix);
         Tango3DR_GridIndexArray t3dr_updated;
         Tango3DR_Status ret;
-        ret = Tango3DR_update(tango.Context(), &t3dr_depth, &t3dr_depth_pose,
-                              &t3dr_image, &t3dr_image_pose, &t3dr_updated);
+        {
+            OC_TRACE_SCOPE("Tango3DR_update");
+            ret = Tango3DR_update(tango.Context(), &t3dr_depth, &t3dr_depth_pose,
+                                  &task.image_info, &t3dr_image_pose, &t3dr_updated);
+        }
         if (ret != TANGO_3DR_SUCCESS)
         {
             binder_mutex_.unlock();
             return;
         }
 
-        texturize.Add(t3dr_image, image_matrix, tango.Dataset());
+        texturize.Add(task.image_info, task.image_matrix, tango.Dataset());
         std::vector<std::pair<GridIndex, Tango3DR_Mesh*> > added;
-        added = scan.Process(tango.Context(), &t3dr_updated);
-        render_mutex_.lock();
+        added = scan.Process(tango.Context(), &t3dr_updated, task.depth_timestamp, task.depth_matrix,
+                             tango.Resolution());
+        render_mutex_.lock(__func__);
         scan.Merge(added);
         render_mutex_.unlock();
 
+        //scanning was stopped, postponed segments would not be extracted anymore
+        if (!t3dr_is_running_ && !replay.IsReplaying())
+            ExtractPostponed();
+
         Tango3DR_GridIndexArray_destroy(&t3dr_updated);
-        point_cloud_available_ = false;
         binder_mutex_.unlock();
     }
 
+    void App::WaitForEffect() {
+        //meshes cannot be touched while the render thread bakes an effect into them
+        if (!effect_pending_ && !effect_baking_)
+            return;
+        effect_baked_.wait_for(render_mutex_, std::chrono::seconds(1), [this] {
+            return !effect_pending_ && !effect_baking_;
+        });
+        //render thread is not running, use CPU
+        if (effect_pending_)
+            editor.ApplyEffect(scene.static_meshes_, effect_, effect_value_, effect_axis_);
+        else if (effect_baking_)
+            scene.feedback->Abandon(&Journal::Transform);
+        else
+            return;
+        scene.SetShader(scene.TexturedVertexShader(), scene.TexturedFragmentShader());
+        effect_pending_ = false;
+        effect_baking_ = false;
+    }
+
+    void App::ExtractPostponed() {
+        std::vector<std::pair<GridIndex, Tango3DR_Mesh*> > added = scan.Flush(tango.Context());
+        render_mutex_.lock(__func__);
+        scan.Merge(added);
+        render_mutex_.unlock();
+    }
+
 
     App::App() :  t3dr_is_running_(false),
+                  effect_pending_(false),
+                  effect_baking_(false),
                   gyro(false),
                   landscape(false),
                   lastMovex(0),
@@ -134,7 +219,11 @@ namespace oc {
                   lastMovez(0),
                   lastPitch(0),
                   lastYaw(0),
-                  point_cloud_available_(false) {}
+                  point_cloud_available_(false),
+                  binder_mutex_("binder_mutex_"),
+                  render_mutex_("render_mutex_"),
+                  callback_mutex_("callback_mutex_"),
+                  integration(kIntegrationQueueSize) {}
 
     void App::OnTangoServiceConnected(JNIEnv *env, jobject binder, double res,
                double dmin, double dmax, int noise, bool land, std::string dataset) {
@@ -154,21 +243,79 @@ namespace oc {
         if (ret != TANGO_SUCCESS)
             std::exit(EXIT_SUCCESS);
 
-        binder_mutex_.lock();
+        binder_mutex_.lock(__func__);
         tango.Connect(this);
         tango.Setup3DR(res, dmin, dmax, noise);
         binder_mutex_.unlock();
+        integration.Start([this](IntegrationTask& task) { Integrate(task); });
+    }
+
+    void App::StartRecording(std::string filename) {
+        replay.StartRecording(filename);
+    }
+
+    void App::StopRecording() {
+        replay.StopRecording();
+    }
+
+    void App::Replay(std::string filename, bool realtime) {
+        //recorded poses replace the pose queries, the rest of the callbacks is shared with live data
+        unsigned long integrated = integration.GetIntegrated();
+        unsigned long stale = integration.GetStale();
+        std::string report = replay.Run(filename, realtime,
+            [this](TangoPointCloud* point_cloud, TangoMatrixTransformData& transform) {
+                ProcessPointCloud(point_cloud, transform);
+            },
+            [this](const TangoImageBuffer* buffer, TangoMatrixTransformData& transform) {
+                return ProcessFrame(buffer, transform);
+            },
+            [this, integrated, stale](unsigned long& done, unsigned long& dropped) {
+                integration.Flush();
+                binder_mutex_.lock("Replay");
+                ExtractPostponed();
+                binder_mutex_.unlock();
+                done = integration.GetIntegrated() - integrated;
+                dropped = integration.GetStale() - stale;
+            });
+        event_mutex_.lock();
+        event_ = report;
+        event_mutex_.unlock();
     }
 
     void App::OnSurfaceChanged(int width, int height) {
-        render_mutex_.lock();
+        render_mutex_.lock(__func__);
+        //feedback is recreated with the viewport, its pending jobs are done on CPU
+        if (effect_baking_) {
+            scene.feedback->Abandon(&Journal::Transform);
+            scene.SetShader(scene.TexturedVertexShader(), scene.TexturedFragmentShader());
+            effect_baking_ = false;
+            effect_baked_.notify_all();
+        }
         scene.SetupViewPort(width, height);
         selector.Init(width, height);
+
+        //compile the preview shader now, dragging a slider then only changes uniforms
+        std::string vs, fs;
+        editor.PreviewShaders(vs, fs);
+        scene.Precompile(vs, fs);
+        scene.Precompile(scene.TexturedVertexShader(), scene.TexturedFragmentShader());
         render_mutex_.unlock();
     }
 
     void App::OnDrawFrame() {
-        render_mutex_.lock();
+        OC_TRACE_SCOPE("App::OnDrawFrame");
+        render_mutex_.lock(__func__);
+        //bake geometry effect requested by ApplyEffect, it is read back on a later frame without a GPU stall
+        if (effect_pending_) {
+            editor.ApplyEffect(scene.static_meshes_, effect_, effect_value_, effect_axis_, scene.feedback);
+            effect_pending_ = false;
+            effect_baking_ = true;
+        } else if (effect_baking_ && scene.feedback->Finish(&Journal::Transform)) {
+            //the preview shader shows the effect until the baked vertices are available
+            scene.SetShader(scene.TexturedVertexShader(), scene.TexturedFragmentShader());
+            effect_baking_ = false;
+            effect_baked_.notify_all();
+        }
         //camera transformation
         if (!gyro) {
             lastMovex = lastMovex * 0.9f + movex * 0.1f;
@@ -194,26 +341,38 @@ namespace oc {
         }
         //render
         scene.Render(gyro);
-        for (std::pair<GridIndex, Tango3DR_Mesh*> s : scan.Data()) {
-            scene.renderer->Render(&s.second->vertices[0][0], 0, 0,
-                                   (unsigned int*)&s.second->colors[0][0],
-                                   s.second->num_faces * 3, &s.second->faces[0][0]);
+        GLCamera& camera = scene.renderer->camera;
+        for (Tango3DR_Mesh* s : scan.RenderList(camera.projection * camera.GetView(), camera.position,
+                                                tango.Resolution())) {
+            scene.renderer->Render(&s->vertices[0][0], 0, 0, (unsigned int*)&s->colors[0][0],
+                                   s->num_faces * 3, &s->faces[0][0]);
         }
         render_mutex_.unlock();
     }
 
     void App::OnToggleButtonClicked(bool t3dr_is_running) {
-        binder_mutex_.lock();
+        binder_mutex_.lock(__func__);
         t3dr_is_running_ = t3dr_is_running;
+        if (!t3dr_is_running)
+            ExtractPostponed();
+        binder_mutex_.unlock();
+    }
+
+    void App::SetExtractionRate(float rate, int limit) {
+        binder_mutex_.lock(__func__);
+        scan.SetRate(rate, (unsigned int) std::max(limit, 0));
         binder_mutex_.unlock();
     }
 
     void App::OnClearButtonClicked() {
-        binder_mutex_.lock();
-        render_mutex_.lock();
+        binder_mutex_.lock(__func__);
+        render_mutex_.lock(__func__);
+        WaitForEffect();
+        integration.Clear();
         scan.Clear();
         tango.Clear();
         texturize.Clear();
+        editor.Clear();
         for (unsigned int i = 0; i < scene.static_meshes_.size(); i++)
             scene.static_meshes_[i].Destroy();
         scene.static_meshes_.clear();
@@ -222,17 +381,43 @@ namespace oc {
     }
 
     void App::Load(std::string filename) {
-        binder_mutex_.lock();
-        render_mutex_.lock();
+        binder_mutex_.lock(__func__);
+        render_mutex_.lock(__func__);
+        WaitForEffect();
+        //atlasing deletes source images and merges submeshes, journal would point to them
+        editor.Clear();
         File3d io(filename, false);
         io.ReadModel(kSubdivisionSize, scene.static_meshes_);
+        Atlas::Process(scene.static_meshes_, kSubdivisionSize);
+        std::vector<Image*> images;
+        for (Mesh& m : scene.static_meshes_)
+            if (m.image && m.imageOwner)
+                images.push_back(m.image);
         render_mutex_.unlock();
+
+        //editing takes only the render mutex, compression runs on a copy of the texels meanwhile
+        for (Image* image : images) {
+            Image copy(image->GetWidth(), image->GetHeight());
+            render_mutex_.lock(__func__);
+            memcpy(copy.GetData(), image->GetData(), (size_t) (image->GetWidth() * image->GetHeight() * 3));
+            copy.SetName(image->GetName());
+            unsigned long revision = image->GetRevision();
+            render_mutex_.unlock();
+            std::vector<std::vector<unsigned char> > levels = copy.Compress();
+
+            //texture edited meanwhile is uploaded uncompressed instead of with stale data
+            render_mutex_.lock(__func__);
+            if (image->GetRevision() == revision)
+                image->SetCompressed(levels);
+            render_mutex_.unlock();
+        }
         binder_mutex_.unlock();
     }
 
     void App::Save(std::string filename) {
-        binder_mutex_.lock();
-        render_mutex_.lock();
+        binder_mutex_.lock(__func__);
+        render_mutex_.lock(__func__);
+        WaitForEffect();
         if (texturize.Init(tango.Context(), tango.Camera())) {
             texturize.Process(filename);
 
@@ -242,13 +427,28 @@ namespace oc {
             File3d(filename, false).ReadModel(kSubdivisionSize, scene.static_meshes_);
         }
         File3d(filename, true).WriteModel(scene.static_meshes_);
+
+        //textures which exist only in memory (atlases) are written next to the model
+        std::string dir = filename.substr(0, filename.rfind('/') + 1);
+        for (Mesh& m : scene.static_meshes_) {
+            if (!m.imageOwner || m.image->GetName().empty())
+                continue;
+            std::string name = m.image->GetName();
+            std::string path = dir + name.substr(name.rfind('/') + 1);
+            FILE* file = fopen(path.c_str(), "rb");
+            if (file)
+                fclose(file);
+            else
+                m.image->Write(path);
+        }
         render_mutex_.unlock();
         binder_mutex_.unlock();
     }
 
     void App::SaveWithTextures(std::string filename) {
-        binder_mutex_.lock();
-        render_mutex_.lock();
+        binder_mutex_.lock(__func__);
+        render_mutex_.lock(__func__);
+        WaitForEffect();
         int index = 0;
         std::vector<std::string> names;
         for (Mesh& m : scene.static_meshes_) {
@@ -273,8 +473,9 @@ namespace oc {
     }
 
     void App::Texturize(std::string filename) {
-        binder_mutex_.lock();
-        render_mutex_.lock();
+        binder_mutex_.lock(__func__);
+        render_mutex_.lock(__func__);
+        WaitForEffect();
 
         //check if texturizing is valid
         if (!texturize.Init(filename, tango.Camera())) {
@@ -291,6 +492,7 @@ namespace oc {
         texturize.Clear();
 
         //reload the model
+        editor.Clear();
         for (unsigned int i = 0; i < scene.static_meshes_.size(); i++)
             scene.static_meshes_[i].Destroy();
         scene.static_meshes_.clear();
@@ -302,8 +504,9 @@ namespace oc {
     }
 
     float App::GetFloorLevel(float x, float y, float z) {
-        binder_mutex_.lock();
-        render_mutex_.lock();
+        binder_mutex_.lock(__func__);
+        render_mutex_.lock(__func__);
+        WaitForEffect();
         float output = INT_MAX;
         glm::vec3 p = glm::vec3(x, z, y);
         for (unsigned int i = 0; i < scene.static_meshes_.size(); i++) {
@@ -321,26 +524,51 @@ namespace oc {
     }
 
     void App::ApplyEffect(Effector::Effect effect, float value, int axis) {
-        render_mutex_.lock();
-        editor.ApplyEffect(scene.static_meshes_, effect, value, axis);
-        scene.vertex = scene.TexturedVertexShader();
-        scene.fragment = scene.TexturedFragmentShader();
+        render_mutex_.lock(__func__);
+        WaitForEffect();
+        bool geometry = (effect == Effector::MOVE) || (effect == Effector::ROTATE) || (effect == Effector::SCALE);
+        if (geometry && scene.feedback) {
+            //GL context lives on render thread, the preview is shown until it is baked there
+            effect_ = effect;
+            effect_value_ = value;
+            effect_axis_ = axis;
+            effect_pending_ = true;
+        } else {
+            editor.ApplyEffect(scene.static_meshes_, effect, value, axis);
+            scene.SetShader(scene.TexturedVertexShader(), scene.TexturedFragmentShader());
+        }
         render_mutex_.unlock();
     }
 
     void App::PreviewEffect(Effector::Effect effect, float value, int axis) {
-        render_mutex_.lock();
-        std::string vs = scene.TexturedVertexShader();
-        std::string fs = scene.TexturedFragmentShader();
-        editor.PreviewEffect(vs, fs, effect, axis);
-        scene.vertex = vs;
-        scene.fragment = fs;
+        render_mutex_.lock(__func__);
+        WaitForEffect();
+        std::string vs, fs;
+        editor.PreviewShaders(vs, fs);
+        scene.SetShader(vs, fs);
         scene.uniform = value / 255.0f;
+        scene.uniformAxis = axis;
+        scene.uniformEffect = effect;
+        render_mutex_.unlock();
+    }
+
+    void App::Redo() {
+        render_mutex_.lock(__func__);
+        WaitForEffect();
+        editor.Redo(scene.static_meshes_);
+        render_mutex_.unlock();
+    }
+
+    void App::Undo() {
+        render_mutex_.lock(__func__);
+        WaitForEffect();
+        editor.Undo(scene.static_meshes_);
         render_mutex_.unlock();
     }
 
     void App::ApplySelection(float x, float y, bool triangle) {
-        render_mutex_.lock();
+        render_mutex_.lock(__func__);
+        WaitForEffect();
         glm::mat4 matrix = scene.renderer->camera.projection * scene.renderer->camera.GetView();
         if (triangle)
           selector.SelectTriangle(scene.static_meshes_, matrix, x, y);
@@ -353,7 +581,8 @@ namespace oc {
     }
 
     void App::CompleteSelection(bool inverse) {
-        render_mutex_.lock();
+        render_mutex_.lock(__func__);
+        WaitForEffect();
         selector.CompleteSelection(scene.static_meshes_, inverse);
         glm::vec3 center = selector.GetCenter(scene.static_meshes_);
         editor.SetCenter(center);
@@ -362,7 +591,8 @@ namespace oc {
     }
 
     void App::MultSelection(bool increase) {
-        render_mutex_.lock();
+        render_mutex_.lock(__func__);
+        WaitForEffect();
         if (increase)
             selector.IncreaseSelection(scene.static_meshes_);
         else
@@ -374,7 +604,8 @@ namespace oc {
     }
 
     void App::RectSelection(float x1, float y1, float x2, float y2) {
-        render_mutex_.lock();
+        render_mutex_.lock(__func__);
+        WaitForEffect();
         glm::mat4 matrix = scene.renderer->camera.projection * scene.renderer->camera.GetView();
         selector.SelectRect(scene.static_meshes_, matrix, x1, y1, x2, y2);
         glm::vec3 center = selector.GetCenter(scene.static_meshes_);
@@ -434,11 +665,32 @@ Java_com_lvonasek_openconstructor_TangoJNINative_onToggleButtonClicked(
   app.OnToggleButtonClicked(t3dr_is_running);
 }
 
+JNIEXPORT void JNICALL
+Java_com_lvonasek_openconstructor_TangoJNINative_setExtractionRate(
+    JNIEnv*, jobject, jfloat rate, jint limit) {
+  app.SetExtractionRate(rate, limit);
+}
+
 JNIEXPORT void JNICALL
 Java_com_lvonasek_openconstructor_TangoJNINative_onClearButtonClicked(JNIEnv*, jobject) {
   app.OnClearButtonClicked();
 }
 
+JNIEXPORT void JNICALL
+Java_com_lvonasek_openconstructor_TangoJNINative_startRecording(JNIEnv* env, jobject, jstring name) {
+  app.StartRecording(jstring2string(env, name));
+}
+
+JNIEXPORT void JNICALL
+Java_com_lvonasek_openconstructor_TangoJNINative_stopRecording(JNIEnv*, jobject) {
+  app.StopRecording();
+}
+
+JNIEXPORT void JNICALL
+Java_com_lvonasek_openconstructor_TangoJNINative_replay(JNIEnv* env, jobject, jstring name, jboolean realtime) {
+  app.Replay(jstring2string(env, name), realtime);
+}
+
 JNIEXPORT void JNICALL
 Java_com_lvonasek_openconstructor_TangoJNINative_load(JNIEnv* env, jobject, jstring name) {
   app.Load(jstring2string(env, name));
@@ -480,6 +732,16 @@ Java_com_lvonasek_openconstructor_TangoJNINative_previewEffect(JNIEnv*, jobject,
     app.PreviewEffect((oc::Effector::Effect) effect, value, axis);
 }
 
+JNIEXPORT void JNICALL
+Java_com_lvonasek_openconstructor_TangoJNINative_redo(JNIEnv*, jobject) {
+    app.Redo();
+}
+
+JNIEXPORT void JNICALL
+Java_com_lvonasek_openconstructor_TangoJNINative_undo(JNIEnv*, jobject) {
+    app.Undo();
+}
+
 JNIEXPORT void JNICALL
 Java_com_lvonasek_openconstructor_TangoJNINative_applySelect(JNIEnv*, jobject, jfloat x, jfloat y, jboolean triangle) {
     app.ApplySelection(x, y, triangle);
@@ -511,6 +773,41 @@ Java_com_lvonasek_openconstructor_TangoJNINative_getEvent(JNIEnv* env, jobject)
   return bytes;
 }
 
+JNIEXPORT jboolean JNICALL
+Java_com_lvonasek_openconstructor_TangoJNINative_exportTrace(JNIEnv* env, jobject, jstring name) {
+  return app.ExportTrace(jstring2string(env, name));
+}
+
+JNIEXPORT jbyteArray JNICALL
+Java_com_lvonasek_openconstructor_TangoJNINative_getTraceStats(JNIEnv* env, jobject) {
+  std::string message = app.GetTraceStats();
+  int byteCount = (int) message.length();
+  const jbyte* pNativeMessage = reinterpret_cast<const jbyte*>(message.c_str());
+  jbyteArray bytes = env->NewByteArray(byteCount);
+  env->SetByteArrayRegion(bytes, 0, byteCount, pNativeMessage);
+  return bytes;
+}
+
+JNIEXPORT jbyteArray JNICALL
+Java_com_lvonasek_openconstructor_TangoJNINative_getLockReport(JNIEnv* env, jobject) {
+  std::string message = app.GetLockReport();
+  int byteCount = (int) message.length();
+  const jbyte* pNativeMessage = reinterpret_cast<const jbyte*>(message.c_str());
+  jbyteArray bytes = env->NewByteArray(byteCount);
+  env->SetByteArrayRegion(bytes, 0, byteCount, pNativeMessage);
+  return bytes;
+}
+
+JNIEXPORT jbyteArray JNICALL
+Java_com_lvonasek_openconstructor_TangoJNINative_getMeshPoolStats(JNIEnv* env, jobject) {
+  std::string message = app.GetMeshPoolStats();
+  int byteCount = (int) message.length();
+  const jbyte* pNativeMessage = reinterpret_cast<const jbyte*>(message.c_str());
+  jbyteArray bytes = env->NewByteArray(byteCount);
+  env->SetByteArrayRegion(bytes, 0, byteCount, pNativeMessage);
+  return bytes;
+}
+
 #ifndef NDEBUG
 JNIEXPORT jbyteArray JNICALL
 Java_com_lvonasek_openconstructor_TangoJNINative_clientSecret(JNIEnv* env, jobject) {
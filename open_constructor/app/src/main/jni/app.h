@@ -1,12 +1,18 @@
 #ifndef APP_H
 #define APP_H
 
+#include <condition_variable>
 #include <jni.h>
 #include <mutex>
 #include <string>
 
+#include "data/atlas.h"
+#include "data/mutex.h"
+#include "data/trace.h"
 #include "editor/effector.h"
 #include "editor/selector.h"
+#include "tango/integration.h"
+#include "tango/replay.h"
 #include "tango/scan.h"
 #include "tango/service.h"
 #include "tango/texturize.h"
@@ -26,6 +32,11 @@ namespace oc {
         void OnDrawFrame();
         void OnToggleButtonClicked(bool t3dr_is_running);
         void OnClearButtonClicked();
+        void SetExtractionRate(float rate, int limit);
+
+        void StartRecording(std::string filename);
+        void StopRecording();
+        void Replay(std::string filename, bool realtime);
 
         void Load(std::string filename);
         void Save(std::string filename);
@@ -35,9 +46,15 @@ namespace oc {
         float GetFloorLevel(float x, float y, float z);
         void SetView(float p, float y, float mx, float my, float mz, bool g);
         std::string GetEvent();
+        bool ExportTrace(std::string filename);
+        std::string GetTraceStats();
+        std::string GetLockReport();
+        std::string GetMeshPoolStats();
 
         void ApplyEffect(Effector::Effect effect, float value, int axis);
         void PreviewEffect(Effector::Effect effect, float value, int axis);
+        void Redo();
+        void Undo();
 
         void ApplySelection(float x, float y, bool triangle);
         void CompleteSelection(bool inverse);
@@ -45,23 +62,37 @@ namespace oc {
         void RectSelection(float x1, float y1, float x2, float y2);
 
     private:
+        void ProcessPointCloud(TangoPointCloud *point_cloud, TangoMatrixTransformData& matrix_transform);
+        bool ProcessFrame(const TangoImageBuffer *buffer, TangoMatrixTransformData& matrix_transform);
+        void Integrate(IntegrationTask& task);
+        void ExtractPostponed();
+        void WaitForEffect();
+
         bool t3dr_is_running_;
         bool point_cloud_available_;
         TangoPointCloud* front_cloud_;
         glm::mat4 point_cloud_matrix_;
-        glm::mat4 image_matrix;
         glm::quat image_rotation;
-        std::mutex binder_mutex_;
-        std::mutex render_mutex_;
+        ProfiledMutex binder_mutex_;
+        ProfiledMutex render_mutex_;
+        ProfiledMutex callback_mutex_;
+        std::condition_variable_any effect_baked_;
         std::mutex event_mutex_;
         std::string event_;
 
         Effector editor;
+        bool effect_pending_;
+        bool effect_baking_;
+        Effector::Effect effect_;
+        float effect_value_;
+        int effect_axis_;
         Scene scene;
         Selector selector;
+        TangoReplay replay;
         TangoScan scan;
         TangoService tango;
         TangoTexturize texturize;
+        TangoIntegration integration;
 
         bool gyro;
         bool landscape;
@@ -0,0 +1,190 @@
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <set>
+#include <sstream>
+#include "data/atlas.h"
+
+namespace oc {
+
+    const int kAtlasSize = 2048;
+    const int kAtlasPadding = 2;
+
+    void Atlas::Process(std::vector<Mesh>& meshes, int subdivision) {
+        //only textures used by meshes with complete uvs in range of the texture can be moved,
+        //repeating textures cannot be sampled from an atlas
+        std::vector<Image*> images;
+        std::set<Image*> invalid;
+        for (Mesh& m : meshes) {
+            if (!m.image)
+                continue;
+            if (std::find(images.begin(), images.end(), m.image) == images.end())
+                images.push_back(m.image);
+            if (m.uv.size() != m.vertices.size())
+                invalid.insert(m.image);
+            for (glm::vec2& t : m.uv) {
+                if ((t.s < 0) || (t.s > 1) || (t.t < 0) || (t.t > 1)) {
+                    invalid.insert(m.image);
+                    break;
+                }
+            }
+        }
+        std::vector<Image*> candidates;
+        for (Image* image : images) {
+            int limit = kAtlasSize / 2 - 2 * kAtlasPadding;
+            if ((image->GetWidth() <= limit) && (image->GetHeight() <= limit) && !invalid.count(image))
+                candidates.push_back(image);
+        }
+
+        //atlas with a single texture would not save anything
+        std::vector<glm::ivec2> sizes;
+        std::vector<AtlasRect> rects = Pack(candidates, sizes);
+        std::vector<int> counts(sizes.size(), 0);
+        for (AtlasRect& r : rects)
+            counts[r.atlas]++;
+        std::vector<Image*> atlases;
+        for (unsigned int i = 0; i < sizes.size(); i++) {
+            atlases.push_back(counts[i] > 1 ? new Image(sizes[i].x, sizes[i].y) : 0);
+            if (atlases.back())
+                memset(atlases.back()->GetData(), 0, (size_t) (sizes[i].x * sizes[i].y * 3));
+        }
+
+        //copy texels and remap uvs
+        std::map<Image*, AtlasRect> packed;
+        for (AtlasRect& r : rects) {
+            Image* atlas = atlases[r.atlas];
+            if (!atlas)
+                continue;
+            if (atlas->GetName().empty())
+                atlas->SetName(GetName(r.image, r.atlas));
+            Blit(atlas, r);
+            packed[r.image] = r;
+        }
+        for (Mesh& m : meshes) {
+            std::map<Image*, AtlasRect>::iterator i = packed.find(m.image);
+            if (i == packed.end())
+                continue;
+            Remap(m, i->second, sizes[i->second.atlas]);
+            m.image = atlases[i->second.atlas];
+        }
+        for (std::pair<Image* const, AtlasRect>& i : packed)
+            delete i.first;
+        LOGI("Atlas packed %d of %d textures into %d atlases", (int)packed.size(), (int)images.size(),
+             (int)(atlases.size() - std::count(atlases.begin(), atlases.end(), (Image*)0)));
+
+        Merge(meshes, subdivision);
+    }
+
+    void Atlas::Blit(Image* atlas, AtlasRect& rect) {
+        //padding repeats the edge texels to avoid bleeding of neighbours while filtering
+        int w = rect.image->GetWidth();
+        int h = rect.image->GetHeight();
+        int stride = atlas->GetWidth() * 3;
+        unsigned char* src = rect.image->GetData();
+        for (int y = -kAtlasPadding; y < h + kAtlasPadding; y++) {
+            unsigned char* row = src + glm::clamp(y, 0, h - 1) * w * 3;
+            unsigned char* dst = atlas->GetData() + (rect.y + y) * stride + rect.x * 3;
+            memcpy(dst, row, (size_t) (w * 3));
+            for (int x = 1; x <= kAtlasPadding; x++) {
+                memcpy(dst - x * 3, row, 3);
+                memcpy(dst + (w - 1 + x) * 3, row + (w - 1) * 3, 3);
+            }
+        }
+    }
+
+    std::string Atlas::GetName(Image* first, int index) {
+        //the atlas file does not exist until the model is saved, its name must not collide with the texture
+        std::string name = first->GetName();
+        std::string::size_type slash = name.rfind('/');
+        std::string::size_type dot = name.rfind('.');
+        if ((dot != std::string::npos) && ((slash == std::string::npos) || (dot > slash)))
+            name = name.substr(0, dot);
+        std::ostringstream ss;
+        ss << name << "_atlas" << index << ".png";
+        return ss.str();
+    }
+
+    void Atlas::Merge(std::vector<Mesh>& meshes, int subdivision) {
+        //append submeshes into the last open submesh with the same texture
+        std::vector<Mesh> output;
+        std::map<Image*, unsigned long> open;
+        for (Mesh& m : meshes) {
+            if (!m.image || !m.indices.empty()) {
+                output.push_back(std::move(m));
+                continue;
+            }
+            std::map<Image*, unsigned long>::iterator i = open.find(m.image);
+            if (i != open.end()) {
+                Mesh& target = output[i->second];
+                bool compatible = (target.normals.empty() == m.normals.empty()) &&
+                                  (target.uv.size() == target.vertices.size()) && (m.uv.size() == m.vertices.size());
+                if (m.vertices.empty() || (compatible && (target.vertices.size() + m.vertices.size() <=
+                                                          (unsigned long)subdivision * 3))) {
+                    target.vertices.insert(target.vertices.end(), m.vertices.begin(), m.vertices.end());
+                    target.normals.insert(target.normals.end(), m.normals.begin(), m.normals.end());
+                    target.colors.insert(target.colors.end(), m.colors.begin(), m.colors.end());
+                    target.uv.insert(target.uv.end(), m.uv.begin(), m.uv.end());
+                    continue;
+                }
+            }
+            open[m.image] = output.size();
+            output.push_back(std::move(m));
+        }
+
+        //every texture is owned by exactly one submesh
+        std::set<Image*> owned;
+        for (Mesh& m : output)
+            if (m.image)
+                m.imageOwner = owned.insert(m.image).second;
+        LOGI("Atlas merged %d submeshes into %d", (int)meshes.size(), (int)output.size());
+        meshes.swap(output);
+    }
+
+    std::vector<AtlasRect> Atlas::Pack(std::vector<Image*>& images, std::vector<glm::ivec2>& sizes) {
+        std::vector<Image*> sorted = images;
+        std::stable_sort(sorted.begin(), sorted.end(), [](Image* a, Image* b) {
+            return a->GetHeight() > b->GetHeight();
+        });
+
+        //shelf packing, the tallest textures first
+        std::vector<AtlasRect> output;
+        int x = 0, y = 0, shelf = 0;
+        for (Image* image : sorted) {
+            int w = image->GetWidth() + 2 * kAtlasPadding;
+            int h = image->GetHeight() + 2 * kAtlasPadding;
+            if (x + w > kAtlasSize) {
+                x = 0;
+                y += shelf;
+                shelf = 0;
+            }
+            if (sizes.empty() || (y + h > kAtlasSize)) {
+                sizes.push_back(glm::ivec2(0, 0));
+                x = 0;
+                y = 0;
+                shelf = 0;
+            }
+            AtlasRect rect;
+            rect.image = image;
+            rect.x = x + kAtlasPadding;
+            rect.y = y + kAtlasPadding;
+            rect.atlas = (int)sizes.size() - 1;
+            output.push_back(rect);
+            x += w;
+            shelf = glm::max(shelf, h);
+            sizes.back().x = glm::max(sizes.back().x, x);
+            sizes.back().y = glm::max(sizes.back().y, y + h);
+        }
+        return output;
+    }
+
+    void Atlas::Remap(Mesh& mesh, AtlasRect& rect, glm::ivec2 size) {
+        //textures are sampled with flipped v, uvs are in range 0-1
+        float w = rect.image->GetWidth();
+        float h = rect.image->GetHeight();
+        for (glm::vec2& t : mesh.uv) {
+            float v = 1.0f - t.t;
+            t.s = (rect.x + t.s * w) / (float)size.x;
+            t.t = 1.0f - (rect.y + v * h) / (float)size.y;
+        }
+    }
+}
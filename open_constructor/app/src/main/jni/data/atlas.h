@@ -0,0 +1,35 @@
+#ifndef DATA_ATLAS_H
+#define DATA_ATLAS_H
+
+#include <string>
+#include <vector>
+#include "data/mesh.h"
+
+namespace oc {
+
+    struct AtlasRect {
+        Image* image; ///< Packed source texture
+        int x, y;     ///< Position of the texture in the atlas, without padding
+        int atlas;    ///< Index of the atlas
+    };
+
+    class Atlas {
+    public:
+        /**
+         * Packs small textures into shared atlases and merges submeshes using the same texture,
+         * textures are replaced by atlases and uvs are remapped
+         * @param meshes is model to be repacked, ownership of the images is kept consistent
+         * @param subdivision is maximal count of triangles in one submesh
+         */
+        static void Process(std::vector<Mesh>& meshes, int subdivision);
+
+    private:
+        static void Blit(Image* atlas, AtlasRect& rect);
+        static std::string GetName(Image* first, int index);
+        static void Merge(std::vector<Mesh>& meshes, int subdivision);
+        static std::vector<AtlasRect> Pack(std::vector<Image*>& images, std::vector<glm::ivec2>& sizes);
+        static void Remap(Mesh& mesh, AtlasRect& rect, glm::ivec2 size);
+    };
+}
+
+#endif
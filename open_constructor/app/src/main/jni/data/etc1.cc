@@ -0,0 +1,227 @@
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include "data/etc1.h"
+#include "data/parallel.h"
+
+namespace {
+    const int kModifiers[8][2] = {{2, 8}, {5, 17}, {9, 29}, {13, 42},
+                                  {18, 60}, {24, 80}, {33, 106}, {47, 183}};
+
+    int Clamp(int value) {
+        return value < 0 ? 0 : (value > 255 ? 255 : value);
+    }
+
+    int Modifier(int table, int index) {
+        //index bits are [negative, large]
+        int value = kModifiers[table][index & 1];
+        return index & 2 ? -value : value;
+    }
+
+    bool InSubblock(int x, int y, int sub, bool flip) {
+        return (flip ? y / 2 : x / 2) == sub;
+    }
+
+    int FindTable(const unsigned char* texels, const int* base, int sub, bool flip, int& table) {
+        //test all tables with the best modifier for every texel
+        int best = INT_MAX;
+        for (int t = 0; t < 8; t++) {
+            int error = 0;
+            for (int i = 0; i < 16; i++) {
+                if (!InSubblock(i % 4, i / 4, sub, flip))
+                    continue;
+                int texel = INT_MAX;
+                for (int m = 0; m < 4; m++) {
+                    int e = 0;
+                    for (int c = 0; c < 3; c++) {
+                        int d = Clamp(base[c] + Modifier(t, m)) - texels[i * 3 + c];
+                        e += d * d;
+                    }
+                    if (texel > e)
+                        texel = e;
+                }
+                error += texel;
+            }
+            if (best > error) {
+                best = error;
+                table = t;
+            }
+        }
+        return best;
+    }
+}
+
+namespace oc {
+
+    std::vector<unsigned char> ETC1::Encode(const unsigned char* rgb, int w, int h) {
+        std::vector<unsigned char> output(Size(w, h));
+        int blocks = (w + 3) / 4;
+        Parallel((unsigned long) ((h + 3) / 4), [rgb, w, h, blocks, &output](unsigned long row) {
+            unsigned char texels[16 * 3];
+            unsigned char* block = output.data() + row * blocks * 8;
+            int by = (int) row * 4;
+            for (int bx = 0; bx < w; bx += 4) {
+                //texels outside of the image repeat the edge
+                for (int y = 0; y < 4; y++) {
+                    for (int x = 0; x < 4; x++) {
+                        int sx = bx + x < w ? bx + x : w - 1;
+                        int sy = by + y < h ? by + y : h - 1;
+                        memcpy(texels + (y * 4 + x) * 3, rgb + (sy * w + sx) * 3, 3);
+                    }
+                }
+                EncodeBlock(texels, block);
+                block += 8;
+            }
+        });
+        return output;
+    }
+
+    void ETC1::Decode(const unsigned char* etc, int w, int h, unsigned char* rgb) {
+        unsigned char texels[16 * 3];
+        for (int by = 0; by < h; by += 4) {
+            for (int bx = 0; bx < w; bx += 4) {
+                DecodeBlock(etc, texels);
+                etc += 8;
+                for (int y = 0; (y < 4) && (by + y < h); y++)
+                    for (int x = 0; (x < 4) && (bx + x < w); x++)
+                        memcpy(rgb + ((by + y) * w + bx + x) * 3, texels + (y * 4 + x) * 3, 3);
+            }
+        }
+    }
+
+    std::vector<unsigned char> ETC1::Downscale(const unsigned char* rgb, int w, int h) {
+        int ow = w > 1 ? w / 2 : 1;
+        int oh = h > 1 ? h / 2 : 1;
+        std::vector<unsigned char> output((unsigned long) (ow * oh * 3));
+        for (int y = 0; y < oh; y++) {
+            int y1 = std::min(y * 2, h - 1);
+            int y2 = std::min(y * 2 + 1, h - 1);
+            for (int x = 0; x < ow; x++) {
+                int x1 = std::min(x * 2, w - 1);
+                int x2 = std::min(x * 2 + 1, w - 1);
+                for (int c = 0; c < 3; c++) {
+                    int sum = rgb[(y1 * w + x1) * 3 + c] + rgb[(y1 * w + x2) * 3 + c] +
+                              rgb[(y2 * w + x1) * 3 + c] + rgb[(y2 * w + x2) * 3 + c];
+                    output[(y * ow + x) * 3 + c] = (unsigned char) ((sum + 2) / 4);
+                }
+            }
+        }
+        return output;
+    }
+
+    unsigned long ETC1::Size(int w, int h) {
+        return (unsigned long) (((w + 3) / 4) * ((h + 3) / 4) * 8);
+    }
+
+    void ETC1::DecodeBlock(const unsigned char* block, unsigned char* texels) {
+        unsigned int hi = (block[0] << 24) | (block[1] << 16) | (block[2] << 8) | block[3];
+        unsigned int lo = (block[4] << 24) | (block[5] << 16) | (block[6] << 8) | block[7];
+        bool flip = (hi & 1) != 0;
+        bool diff = (hi & 2) != 0;
+        int table[2] = {(int) ((hi >> 5) & 7), (int) ((hi >> 2) & 7)};
+        int base[2][3];
+        for (int c = 0; c < 3; c++) {
+            int shift = 24 - c * 8;
+            if (diff) {
+                int c1 = (hi >> (shift + 3)) & 31;
+                int d = (hi >> shift) & 7;
+                int c2 = c1 + (d >= 4 ? d - 8 : d);
+                base[0][c] = (c1 << 3) | (c1 >> 2);
+                base[1][c] = (c2 << 3) | (c2 >> 2);
+            } else {
+                int c1 = (hi >> (shift + 4)) & 15;
+                int c2 = (hi >> shift) & 15;
+                base[0][c] = c1 | (c1 << 4);
+                base[1][c] = c2 | (c2 << 4);
+            }
+        }
+        for (int y = 0; y < 4; y++) {
+            for (int x = 0; x < 4; x++) {
+                int bit = x * 4 + y;
+                int index = (((lo >> (bit + 16)) & 1) << 1) | ((lo >> bit) & 1);
+                int sub = InSubblock(x, y, 0, flip) ? 0 : 1;
+                for (int c = 0; c < 3; c++)
+                    texels[(y * 4 + x) * 3 + c] = (unsigned char) Clamp(base[sub][c] + Modifier(table[sub], index));
+            }
+        }
+    }
+
+    void ETC1::EncodeBlock(const unsigned char* texels, unsigned char* block) {
+        unsigned int bestHi = 0;
+        int bestError = INT_MAX;
+        int bestBase[2][3];
+        int bestTable[2];
+        for (int flip = 0; flip < 2; flip++) {
+            //average color of subblocks
+            int sum[2][3] = {{0, 0, 0}, {0, 0, 0}};
+            for (int i = 0; i < 16; i++) {
+                int sub = InSubblock(i % 4, i / 4, 0, flip != 0) ? 0 : 1;
+                for (int c = 0; c < 3; c++)
+                    sum[sub][c] += texels[i * 3 + c];
+            }
+
+            //individual mode stores 4 bits per channel, differential mode 5 bits and 3 bits delta
+            for (int diff = 0; diff < 2; diff++) {
+                int q[2][3], base[2][3];
+                bool valid = true;
+                for (int s = 0; s < 2; s++) {
+                    for (int c = 0; c < 3; c++) {
+                        int bits = diff ? 31 : 15;
+                        q[s][c] = (sum[s][c] * bits + 8 * 255 / 2) / (8 * 255);
+                        base[s][c] = diff ? (q[s][c] << 3) | (q[s][c] >> 2) : q[s][c] | (q[s][c] << 4);
+                    }
+                }
+                unsigned int hi = (unsigned int) ((diff << 1) | flip);
+                for (int c = 0; c < 3; c++) {
+                    int shift = 24 - c * 8;
+                    if (diff) {
+                        int d = q[1][c] - q[0][c];
+                        if ((d < -4) || (d > 3))
+                            valid = false;
+                        hi |= (q[0][c] << (shift + 3)) | ((d & 7) << shift);
+                    } else
+                        hi |= (q[0][c] << (shift + 4)) | (q[1][c] << shift);
+                }
+                if (!valid)
+                    continue;
+                int table[2];
+                int error = FindTable(texels, base[0], 0, flip != 0, table[0]);
+                error += FindTable(texels, base[1], 1, flip != 0, table[1]);
+                if (bestError > error) {
+                    bestError = error;
+                    bestHi = hi | (table[0] << 5) | (table[1] << 2);
+                    memcpy(bestBase, base, sizeof(base));
+                    memcpy(bestTable, table, sizeof(table));
+                }
+            }
+        }
+
+        //store the best modifier of every texel
+        bool flip = (bestHi & 1) != 0;
+        unsigned int lo = 0;
+        for (int y = 0; y < 4; y++) {
+            for (int x = 0; x < 4; x++) {
+                const unsigned char* texel = texels + (y * 4 + x) * 3;
+                int sub = InSubblock(x, y, 0, flip) ? 0 : 1;
+                int best = INT_MAX, index = 0;
+                for (int m = 0; m < 4; m++) {
+                    int e = 0;
+                    for (int c = 0; c < 3; c++) {
+                        int d = Clamp(bestBase[sub][c] + Modifier(bestTable[sub], m)) - texel[c];
+                        e += d * d;
+                    }
+                    if (best > e) {
+                        best = e;
+                        index = m;
+                    }
+                }
+                int bit = x * 4 + y;
+                lo |= ((index >> 1) << (bit + 16)) | ((index & 1) << bit);
+            }
+        }
+        for (int i = 0; i < 4; i++) {
+            block[i] = (unsigned char) (bestHi >> (24 - i * 8));
+            block[i + 4] = (unsigned char) (lo >> (24 - i * 8));
+        }
+    }
+}
@@ -0,0 +1,48 @@
+#ifndef DATA_ETC1_H
+#define DATA_ETC1_H
+
+#include <vector>
+
+namespace oc {
+
+    class ETC1 {
+    public:
+        /**
+         * Compresses RGB texels into ETC1 blocks, the output is valid ETC2 RGB8 too
+         * @param rgb is input of size w * h * 3
+         * @param w is width in texels
+         * @param h is height in texels
+         * @return compressed blocks ordered by rows
+         */
+        static std::vector<unsigned char> Encode(const unsigned char* rgb, int w, int h);
+
+        /**
+         * Decompresses ETC1 blocks into RGB texels
+         * @param etc is input of Size(w, h) bytes
+         * @param w is width in texels
+         * @param h is height in texels
+         * @param rgb is output of size w * h * 3
+         */
+        static void Decode(const unsigned char* etc, int w, int h, unsigned char* rgb);
+
+        /**
+         * Creates next level of mipmap chain using box filter
+         * @param rgb is input of size w * h * 3
+         * @param w is width in texels
+         * @param h is height in texels
+         * @return texels of size max(w / 2, 1) * max(h / 2, 1) * 3
+         */
+        static std::vector<unsigned char> Downscale(const unsigned char* rgb, int w, int h);
+
+        /**
+         * @return size of compressed data in bytes
+         */
+        static unsigned long Size(int w, int h);
+
+    private:
+        static void DecodeBlock(const unsigned char* block, unsigned char* texels);
+        static void EncodeBlock(const unsigned char* texels, unsigned char* block);
+    };
+}
+
+#endif
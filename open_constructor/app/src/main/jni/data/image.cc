@@ -1,5 +1,7 @@
+#include <mutex>
 #include <png.h>
 #include <turbojpeg.h>
+#include "data/etc1.h"
 #include "data/image.h"
 #include "gl/opengl.h"
 
@@ -15,7 +17,8 @@ tjhandle jpegC = tjInitCompress();
 tjhandle jpegD = tjInitDecompress();
 unsigned char* srcPlanes[3] = {0, 0, 0};
 
-std::vector<long> image_textureToDelete;
+std::mutex image_textureMutex;
+std::vector<unsigned int> image_textureToDelete;
 
 namespace oc {
 
@@ -25,6 +28,7 @@ namespace oc {
         data = new unsigned char[w * h * 3];
         name = "";
         texture = -1;
+        revision = 0;
     }
 
     Image::Image(unsigned char* src, int w, int h, int scale) {
@@ -33,6 +37,7 @@ namespace oc {
         height = h / scale;
         name = "photo";
         texture = -1;
+        revision = 0;
         UpdateYUV(src, w, h, scale);
     }
 
@@ -40,6 +45,7 @@ namespace oc {
         LOGI("Reading %s", filename.c_str());
         name = filename;
         texture = -1;
+        revision = 0;
 
         std::string ext = filename.substr(filename.size() - 3, filename.size() - 1);
         if (ext.compare("jpg") == 0)
@@ -51,6 +57,8 @@ namespace oc {
     }
 
     Image::~Image() {
+        if (texture != -1)
+            UpdateTexture();
         delete[] data;
         if (srcPlanes[1])
             delete srcPlanes[1];
@@ -60,6 +68,68 @@ namespace oc {
         srcPlanes[2] = 0;
     }
 
+    std::vector<std::vector<unsigned char> > Image::Compress() {
+        //texels hash validates the cache, edited textures are encoded again
+        unsigned long long hash = 14695981039346656037ULL;
+        hash = (hash ^ (unsigned long long) width) * 1099511628211ULL;
+        hash = (hash ^ (unsigned long long) height) * 1099511628211ULL;
+        unsigned long size = (unsigned long) (width * height * 3);
+        for (unsigned long i = 0; i < size; i++)
+            hash = (hash ^ data[i]) * 1099511628211ULL;
+        std::string cache = name + ".etc";
+        std::vector<std::vector<unsigned char> > output;
+        if (!name.empty()) {
+            FILE* file = fopen(cache.c_str(), "rb");
+            if (file) {
+                unsigned long long h = 0;
+                unsigned int levels = 0, length = 0;
+                bool valid = (fread(&h, sizeof(h), 1, file) == 1) && (h == hash) &&
+                             (fread(&levels, sizeof(levels), 1, file) == 1);
+                for (unsigned int i = 0; valid && (i < levels); i++) {
+                    valid = fread(&length, sizeof(length), 1, file) == 1;
+                    output.push_back(std::vector<unsigned char>(length));
+                    valid = valid && (fread(output.back().data(), 1, length, file) == length);
+                }
+                fclose(file);
+                if (valid && !output.empty()) {
+                    LOGI("Texture cache %s used", cache.c_str());
+                    return output;
+                }
+                output.clear();
+            }
+        }
+
+        //encode the whole mipmap chain
+        std::vector<unsigned char> level(data, data + size);
+        int w = width;
+        int h = height;
+        while (true) {
+            output.push_back(ETC1::Encode(level.data(), w, h));
+            if ((w == 1) && (h == 1))
+                break;
+            level = ETC1::Downscale(level.data(), w, h);
+            w = w > 1 ? w / 2 : 1;
+            h = h > 1 ? h / 2 : 1;
+        }
+
+        if (name.empty())
+            return output;
+        FILE* file = fopen(cache.c_str(), "wb");
+        if (!file)
+            return output;
+        unsigned int levels = (unsigned int) output.size();
+        fwrite(&hash, sizeof(hash), 1, file);
+        fwrite(&levels, sizeof(levels), 1, file);
+        for (std::vector<unsigned char>& l : output) {
+            unsigned int length = (unsigned int) l.size();
+            fwrite(&length, sizeof(length), 1, file);
+            fwrite(l.data(), 1, length, file);
+        }
+        fclose(file);
+        LOGI("Texture cache %s written", cache.c_str());
+        return output;
+    }
+
     unsigned char* Image::ExtractYUV(unsigned int s) {
         int yIndex = 0;
         unsigned int uvIndex = width * s * height * s;
@@ -94,7 +164,13 @@ namespace oc {
     }
 
     void Image::UpdateTexture() {
-        image_textureToDelete.push_back(texture);
+        revision++;
+        compressed.clear();
+        if (texture == -1)
+            return;
+        image_textureMutex.lock();
+        image_textureToDelete.push_back((unsigned int) texture);
+        image_textureMutex.unlock();
         texture = -1;
     }
 
@@ -335,9 +411,9 @@ namespace oc {
 
     std::vector<unsigned int> Image::TexturesToDelete() {
         std::vector<unsigned int> output;
-        for (long & i : image_textureToDelete)
-            output.push_back((const unsigned int &) i);
-        image_textureToDelete.clear();
+        image_textureMutex.lock();
+        output.swap(image_textureToDelete);
+        image_textureMutex.unlock();
         return output;
     }
 }
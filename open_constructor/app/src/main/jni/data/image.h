@@ -12,7 +12,9 @@ namespace oc {
         Image(unsigned char* src, int w, int h, int scale);
         Image(std::string filename);
         ~Image();
+        std::vector<std::vector<unsigned char> > Compress();
         unsigned char* ExtractYUV(unsigned int s);
+        void SetCompressed(std::vector<std::vector<unsigned char> >& value) { compressed.swap(value); }
         void SetName(std::string value) { name = value; }
         void SetTexture(long value) { texture = value; }
         void UpdateTexture();
@@ -22,8 +24,10 @@ namespace oc {
         int GetWidth() { return width; }
         int GetHeight() { return height; }
         unsigned char* GetData() { return data; }
+        std::vector<std::vector<unsigned char> >& GetCompressed() { return compressed; }
         std::string GetName() { return name; }
         long GetTexture() { return texture; }
+        unsigned long GetRevision() { return revision; }
 
         static void JPG2YUV(std::string filename, unsigned char* data, int width, int height);
         static void YUV2JPG(unsigned char* data, int width, int height, std::string filename);
@@ -40,6 +44,8 @@ namespace oc {
         unsigned char* data;
         std::string name;
         long texture;
+        unsigned long revision;  ///< Incremented by UpdateTexture whenever the texels change
+        std::vector<std::vector<unsigned char> > compressed;
     };
 }
 
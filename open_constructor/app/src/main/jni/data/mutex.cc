@@ -0,0 +1,99 @@
+#include <algorithm>
+#include <sstream>
+#include <vector>
+#include "data/mutex.h"
+#include "data/trace.h"
+
+namespace oc {
+
+    ProfiledMutex::ProfiledMutex(const char* name) : name(name), wait_name(std::string(name) + " wait"),
+                                                     owner(0), acquired(0) {}
+
+    void ProfiledMutex::lock(const char* site) {
+        //uncontended locking costs one clock read
+        long long begin = 0, end = 0;
+        bool contended = !mutex.try_lock();
+        if (contended) {
+            begin = Trace::Now();
+            mutex.lock();
+            end = Trace::Now();
+            acquired = end;
+        } else
+            acquired = Trace::Now();
+        if (!site) {
+            std::map<std::thread::id, const char*>::iterator i = released.find(std::this_thread::get_id());
+            site = i != released.end() ? i->second : "unknown";
+        }
+        owner = site;
+
+        LockSite& s = sites[site];
+        s.count++;
+        if (contended) {
+            s.contended++;
+            s.wait += end - begin;
+            s.wait_max = std::max(s.wait_max, end - begin);
+        }
+#ifdef OC_TRACE
+        Trace::Add(wait_name.c_str(), contended ? begin : acquired, acquired);
+#endif
+    }
+
+    void ProfiledMutex::unlock() {
+        long long hold = Trace::Now() - acquired;
+        LockSite& s = sites[owner];
+        s.hold += hold;
+        s.hold_max = std::max(s.hold_max, hold);
+        released[std::this_thread::get_id()] = owner;
+        owner = 0;
+        mutex.unlock();
+    }
+
+    std::string ProfiledMutex::GetReport() {
+        //sites with the same name are merged
+        mutex.lock();
+        std::map<std::string, LockSite> merged;
+        for (std::pair<const char* const, LockSite>& i : sites) {
+            LockSite& m = merged[i.first];
+            m.count += i.second.count;
+            m.contended += i.second.contended;
+            m.wait += i.second.wait;
+            m.wait_max = std::max(m.wait_max, i.second.wait_max);
+            m.hold += i.second.hold;
+            m.hold_max = std::max(m.hold_max, i.second.hold_max);
+        }
+        mutex.unlock();
+
+        LockSite total = LockSite();
+        std::vector<std::pair<std::string, LockSite> > sorted(merged.begin(), merged.end());
+        for (std::pair<std::string, LockSite>& i : sorted) {
+            total.count += i.second.count;
+            total.contended += i.second.contended;
+            total.wait += i.second.wait;
+            total.wait_max = std::max(total.wait_max, i.second.wait_max);
+            total.hold += i.second.hold;
+            total.hold_max = std::max(total.hold_max, i.second.hold_max);
+        }
+        std::stable_sort(sorted.begin(), sorted.end(), [](const std::pair<std::string, LockSite>& a,
+                                                          const std::pair<std::string, LockSite>& b) {
+            return a.second.wait > b.second.wait;
+        });
+        sorted.insert(sorted.begin(), std::pair<std::string, LockSite>(name, total));
+
+        std::ostringstream ss;
+        ss.precision(3);
+        ss << std::fixed;
+        for (unsigned long i = 0; i < sorted.size(); i++) {
+            LockSite& s = sorted[i].second;
+            ss << (i ? "  " : "") << sorted[i].first << ": " << s.count << " locks, " << s.contended;
+            ss << " contended, wait " << s.wait / 1000000.0 << " ms (max " << s.wait_max / 1000000.0;
+            ss << " ms), hold " << s.hold / 1000000.0 << " ms (max " << s.hold_max / 1000000.0 << " ms)\n";
+        }
+        return ss.str();
+    }
+
+    void ProfiledMutex::ResetStats() {
+        mutex.lock();
+        sites.clear();
+        mutex.unlock();
+    }
+}
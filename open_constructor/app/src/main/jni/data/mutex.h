@@ -0,0 +1,66 @@
+#ifndef DATA_MUTEX_H
+#define DATA_MUTEX_H
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace oc {
+
+    struct LockSite {
+        unsigned long count;      ///< Amount of acquisitions
+        unsigned long contended;  ///< Acquisitions which had to wait for another owner
+        long long wait;           ///< Total wait in nanoseconds
+        long long wait_max;       ///< Longest wait in nanoseconds
+        long long hold;           ///< Total hold in nanoseconds
+        long long hold_max;       ///< Longest hold in nanoseconds
+    };
+
+    class ProfiledMutex {
+    public:
+        /**
+         * @param name is name of the lock in the report, it has to be a string literal
+         */
+        ProfiledMutex(const char* name);
+
+        /**
+         * Locks and records statistics of the call site
+         * @param site is name of the caller, it has to be a string literal like __func__
+         */
+        void lock(const char* site);
+
+        /**
+         * Locks from an unnamed call site, it makes the mutex usable by std::lock_guard and friends.
+         * The site which released the lock last on this thread is used, so a relock done by
+         * a condition variable wait is attributed to the caller of the wait.
+         */
+        void lock() { lock(0); }
+
+        /**
+         * Unlocks and records hold time for the site which locked it
+         */
+        void unlock();
+
+        /**
+         * @return report of waiting and holding per call site, sorted by total wait
+         */
+        std::string GetReport();
+
+        /**
+         * Removes collected statistics
+         */
+        void ResetStats();
+
+    private:
+        std::mutex mutex;
+        const char* name;
+        std::string wait_name;                    ///< Name of wait events in the trace
+        const char* owner;                        ///< Site holding the lock
+        long long acquired;                       ///< Time when the owner got the lock
+        std::map<const char*, LockSite> sites;    ///< Statistics by call site, guarded by mutex
+        std::map<std::thread::id, const char*> released; ///< Last site which unlocked by thread, guarded by mutex
+    };
+}
+
+#endif
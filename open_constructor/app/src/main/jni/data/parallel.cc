@@ -0,0 +1,116 @@
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "data/parallel.h"
+
+namespace {
+
+    struct ParallelJob {
+        unsigned long count;                                   ///< Amount of task indices
+        const std::function<void(unsigned long)>* task;        ///< Function processing one index
+        std::atomic<unsigned long> next;                       ///< Next index to be claimed
+        unsigned long done;                                    ///< Processed indices, guarded by the pool mutex
+        int workers;                                           ///< Pool threads working on the job
+    };
+
+    //threads are started once and wait for jobs, caller of Parallel works on its job too
+    class ParallelPool {
+    public:
+        ParallelPool() : exit(false) {
+            unsigned int count = std::thread::hardware_concurrency();
+            for (unsigned int i = 1; i < count; i++)
+                threads.push_back(std::thread(&ParallelPool::Work, this));
+        }
+
+        ~ParallelPool() {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                exit = true;
+            }
+            wake.notify_all();
+            for (std::thread& t : threads)
+                t.join();
+        }
+
+        void Run(unsigned long count, const std::function<void(unsigned long)>& task) {
+            if (threads.empty() || (count <= 1)) {
+                for (unsigned long i = 0; i < count; i++)
+                    task(i);
+                return;
+            }
+
+            ParallelJob job;
+            job.count = count;
+            job.task = &task;
+            job.next = 0;
+            job.done = 0;
+            job.workers = 0;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                jobs.push_back(&job);
+            }
+            wake.notify_all();
+            unsigned long processed = Process(job);
+
+            //the job can be destroyed only when no thread holds it
+            std::unique_lock<std::mutex> lock(mutex);
+            Remove(&job);
+            job.done += processed;
+            finished.wait(lock, [&job]() { return (job.done == job.count) && (job.workers == 0); });
+        }
+
+    private:
+        static unsigned long Process(ParallelJob& job) {
+            unsigned long processed = 0;
+            for (unsigned long i = job.next++; i < job.count; i = job.next++, processed++)
+                (*job.task)(i);
+            return processed;
+        }
+
+        void Remove(ParallelJob* job) {
+            std::deque<ParallelJob*>::iterator i = std::find(jobs.begin(), jobs.end(), job);
+            if (i != jobs.end())
+                jobs.erase(i);
+        }
+
+        void Work() {
+            std::unique_lock<std::mutex> lock(mutex);
+            while (true) {
+                wake.wait(lock, [this]() { return exit || !jobs.empty(); });
+                if (exit)
+                    return;
+                ParallelJob* job = jobs.front();
+                job->workers++;
+                lock.unlock();
+                unsigned long processed = Process(*job);
+                lock.lock();
+
+                //all indices are claimed, other threads do not need to see the job
+                Remove(job);
+                job->done += processed;
+                job->workers--;
+                if ((job->done == job->count) && (job->workers == 0))
+                    finished.notify_all();
+            }
+        }
+
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::condition_variable finished;
+        std::deque<ParallelJob*> jobs;
+        std::vector<std::thread> threads;
+        bool exit;
+    };
+}
+
+namespace oc {
+
+    void Parallel(unsigned long count, const std::function<void(unsigned long)>& task) {
+        static ParallelPool pool;
+        pool.Run(count, task);
+    }
+}
@@ -0,0 +1,16 @@
+#ifndef DATA_PARALLEL_H
+#define DATA_PARALLEL_H
+
+#include <functional>
+
+namespace oc {
+
+    /**
+     * @brief Parallel runs task for every index from 0 to count - 1 on all CPU cores
+     * @param count is amount of tasks
+     * @param task is function processing one task index, it has to be thread safe
+     */
+    void Parallel(unsigned long count, const std::function<void(unsigned long)>& task);
+}
+
+#endif
@@ -0,0 +1,120 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include "data/trace.h"
+
+namespace {
+    const unsigned long kTraceCapacity = 16384;
+
+    struct TraceBuffer {
+        std::mutex mutex;
+        std::vector<oc::TraceEvent> events;
+        unsigned long count;
+
+        TraceBuffer() : events(kTraceCapacity), count(0) {}
+    };
+
+    TraceBuffer& Buffer() {
+        static TraceBuffer buffer;
+        return buffer;
+    }
+
+    int ThreadId() {
+        static std::atomic<int> next(1);
+        thread_local int id = next++;
+        return id;
+    }
+}
+
+namespace oc {
+
+    void Trace::Add(const char* name, long long begin, long long end) {
+        TraceEvent event;
+        event.name = name;
+        event.begin = begin;
+        event.end = end;
+        event.thread = ThreadId();
+        TraceBuffer& buffer = Buffer();
+        std::lock_guard<std::mutex> lock(buffer.mutex);
+        buffer.events[buffer.count++ % kTraceCapacity] = event;
+    }
+
+    void Trace::Clear() {
+        TraceBuffer& buffer = Buffer();
+        std::lock_guard<std::mutex> lock(buffer.mutex);
+        buffer.count = 0;
+    }
+
+    bool Trace::Export(std::string filename) {
+        FILE* file = fopen(filename.c_str(), "w");
+        if (!file)
+            return false;
+        std::vector<TraceEvent> events = Snapshot();
+        fprintf(file, "{\"traceEvents\":[");
+        for (unsigned long i = 0; i < events.size(); i++) {
+            //complete events with microsecond timestamps
+            fprintf(file, "%s\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                    i ? "," : "", events[i].name, events[i].thread, events[i].begin / 1000.0,
+                    (events[i].end - events[i].begin) / 1000.0);
+        }
+        fprintf(file, "\n],\"displayTimeUnit\":\"ms\"}\n");
+        fclose(file);
+        return true;
+    }
+
+    std::vector<TraceStats> Trace::GetStats() {
+        std::map<std::string, std::vector<double> > durations;
+        for (TraceEvent& e : Snapshot())
+            durations[e.name].push_back((e.end - e.begin) / 1000000.0);
+        std::vector<TraceStats> output;
+        for (std::pair<const std::string, std::vector<double> >& i : durations) {
+            TraceStats stats;
+            stats.name = i.first;
+            stats.count = (int) i.second.size();
+            stats.p50 = Percentile(i.second, 50);
+            stats.p95 = Percentile(i.second, 95);
+            stats.p99 = Percentile(i.second, 99);
+            output.push_back(stats);
+        }
+        return output;
+    }
+
+    std::string Trace::GetStatsText() {
+        std::ostringstream ss;
+        ss.precision(3);
+        ss << std::fixed;
+        for (TraceStats& s : GetStats()) {
+            ss << s.name << ": " << s.count << "x, p50 " << s.p50 << " ms, p95 " << s.p95;
+            ss << " ms, p99 " << s.p99 << " ms\n";
+        }
+        return ss.str();
+    }
+
+    long long Trace::Now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    double Trace::Percentile(std::vector<double>& values, double p) {
+        if (values.empty())
+            return 0;
+        std::sort(values.begin(), values.end());
+        unsigned long index = (unsigned long) (p / 100.0 * (values.size() - 1) + 0.5);
+        return values[std::min(index, (unsigned long) values.size() - 1)];
+    }
+
+    std::vector<TraceEvent> Trace::Snapshot() {
+        //events ordered from the oldest one
+        TraceBuffer& buffer = Buffer();
+        std::lock_guard<std::mutex> lock(buffer.mutex);
+        std::vector<TraceEvent> output;
+        unsigned long first = buffer.count > kTraceCapacity ? buffer.count - kTraceCapacity : 0;
+        for (unsigned long i = first; i < buffer.count; i++)
+            output.push_back(buffer.events[i % kTraceCapacity]);
+        return output;
+    }
+}
@@ -0,0 +1,92 @@
+#ifndef DATA_TRACE_H
+#define DATA_TRACE_H
+
+#include <string>
+#include <vector>
+
+//probes are compiled only with OC_TRACE defined, otherwise they cost nothing
+#ifdef OC_TRACE
+#define OC_TRACE_CONCAT_(a, b) a##b
+#define OC_TRACE_CONCAT(a, b) OC_TRACE_CONCAT_(a, b)
+#define OC_TRACE_SCOPE(name) oc::TraceScope OC_TRACE_CONCAT(trace_scope_, __LINE__)(name)
+#else
+#define OC_TRACE_SCOPE(name)
+#endif
+
+namespace oc {
+
+    struct TraceEvent {
+        const char* name;  ///< Static name of the stage
+        long long begin;   ///< Start in nanoseconds of the steady clock
+        long long end;     ///< End in nanoseconds of the steady clock
+        int thread;        ///< Sequential id of the thread
+    };
+
+    struct TraceStats {
+        std::string name;  ///< Name of the stage
+        int count;         ///< Amount of events in the window
+        double p50;        ///< Median duration in milliseconds
+        double p95;        ///< 95th percentile of duration in milliseconds
+        double p99;        ///< 99th percentile of duration in milliseconds
+    };
+
+    class Trace {
+    public:
+        /**
+         * Stores an event into the ring buffer, the oldest event is overwritten when it is full
+         * @param name is name of the stage, it has to be a string literal
+         * @param begin is start from Now()
+         * @param end is end from Now()
+         */
+        static void Add(const char* name, long long begin, long long end);
+
+        /**
+         * Removes all events
+         */
+        static void Clear();
+
+        /**
+         * Writes events in the ring buffer in Chrome trace JSON format, it opens in chrome://tracing and Perfetto
+         * @param filename is path of the output file
+         * @return true if the file was written
+         */
+        static bool Export(std::string filename);
+
+        /**
+         * @return duration statistics of the events in the ring buffer by stage
+         */
+        static std::vector<TraceStats> GetStats();
+
+        /**
+         * @return human readable statistics, one stage per line
+         */
+        static std::string GetStatsText();
+
+        /**
+         * @return time in nanoseconds of the steady clock
+         */
+        static long long Now();
+
+        /**
+         * @param values are samples, they get sorted
+         * @param p is percentile from interval 0 to 100
+         * @return value of the percentile or zero for no samples
+         */
+        static double Percentile(std::vector<double>& values, double p);
+
+    private:
+        static std::vector<TraceEvent> Snapshot();
+    };
+
+    class TraceScope {
+    public:
+        TraceScope(const char* name) : name(name), begin(Trace::Now()) {}
+        ~TraceScope() { Trace::Add(name, begin, Trace::Now()); }
+
+    private:
+        const char* name;
+        long long begin;
+    };
+}
+
+#endif
@@ -1,10 +1,50 @@
+#include <sstream>
 #include "data/file3d.h"
+#include "data/parallel.h"
 #include "editor/effector.h"
 #include "editor/selector.h"
 
+namespace {
+    typedef int texels4 __attribute__((vector_size(16)));
+
+    inline int SaturateTexel(int v, int c, int k) {
+        v += (v - c) * k / 65536;
+        return v < 0 ? 0 : (v > 255 ? 255 : v);
+    }
+
+    inline texels4 SaturateTexels(texels4 v, texels4 c, int k) {
+        texels4 d = (v - c) * k;
+        v += (d + ((d >> 31) & 65535)) >> 16;
+        v &= v > 0;
+        texels4 over = v > 255;
+        return (v & ~over) | (over & 255);
+    }
+
+    void SaturateRun(unsigned char* data, int k) {
+        texels4 r, g, b;
+        for (int j = 0; j < 8; j += 4, data += 12) {
+            for (int i = 0; i < 4; i++) {
+                r[i] = data[i * 3 + 0];
+                g[i] = data[i * 3 + 1];
+                b[i] = data[i * 3 + 2];
+            }
+            //division by 3 done as multiplication, it is exact for sums up to 765
+            texels4 c = ((r + g + b) * 21846) >> 16;
+            r = SaturateTexels(r, c, k);
+            g = SaturateTexels(g, c, k);
+            b = SaturateTexels(b, c, k);
+            for (int i = 0; i < 4; i++) {
+                data[i * 3 + 0] = (unsigned char) r[i];
+                data[i * 3 + 1] = (unsigned char) g[i];
+                data[i * 3 + 2] = (unsigned char) b[i];
+            }
+        }
+    }
+}
+
 namespace oc {
 
-    void Effector::ApplyEffect(std::vector<Mesh> &mesh, Effector::Effect e, float value, int axis) {
+    void Effector::ApplyEffect(std::vector<Mesh> &mesh, Effector::Effect e, float value, int axis, GLFeedback* gpu) {
 
         if (mesh.empty())
             return;
@@ -12,286 +52,343 @@ namespace oc {
         if ((e == CONTRAST) || (e == GAMMA) || (e == SATURATION) || (e == TONE) || (e == RESET))
             ApplyColorEffect(mesh, e, value);
         else
-            ApplyGeometryEffect(mesh, e, value, axis);
-    }
-
-    void Effector::PreviewEffect(std::string& vs, std::string& fs, Effector::Effect e, int axis) {
-        if ((e == CONTRAST) || (e == GAMMA) || (e == SATURATION) || (e == TONE) || (e == RESET))
-            PreviewColorEffect(fs, e);
-        else
-            PreviewGeometryEffect(vs, e, axis);
+            ApplyGeometryEffect(mesh, e, value, axis, gpu);
     }
 
     void Effector::ApplyColorEffect(std::vector<Mesh> &mesh, Effector::Effect effect, float value) {
-        // create masks
+        // create masks, texels are edited on the CPU even if the texture is not uploaded
+        unsigned int used = 0;
         for (Mesh& m : mesh) {
-            if (!m.image || (m.image->GetTexture() == -1))
+            if (!m.image)
                 continue;
-            if (texture2mask.find(m.image->GetTexture()) == texture2mask.end()) {
-                mask = new bool[m.image->GetWidth() * m.image->GetHeight()];
-                for (unsigned int i = 0; i < m.image->GetWidth() * m.image->GetHeight(); i++)
-                    mask[i] = false;
-                texture2mask[m.image->GetTexture()] = mask;
+            if (image2mask.find(m.image) == image2mask.end()) {
+                if (used == maskPool.size())
+                    maskPool.push_back(std::vector<unsigned int>());
+                int stride = (m.image->GetWidth() + 31) / 32;
+                maskPool[used].assign((unsigned long) (stride * m.image->GetHeight()), 0);
+                image2mask[m.image] = used++;
             }
         }
 
         // fill masks
         for (Mesh& m : mesh) {
-            if (!m.image || (m.image->GetTexture() == -1))
+            if (!m.image)
                 continue;
-            mask = texture2mask[m.image->GetTexture()];
+            mask = maskPool[image2mask[m.image]].data();
+            maskStride = (m.image->GetWidth() + 31) / 32;
             SetResolution(m.image->GetWidth(), m.image->GetHeight());
             AddUVS(m.uv, m.colors);
         }
 
-        // apply effect
-        float fValue = value / 255.0f;
+        // apply effect in parallel over row bands of all textures
+        struct Band {
+            Image* image;
+            unsigned int* mask;
+            int y;
+            std::vector<JournalTile> changed;
+            std::vector<JournalTile> originals;
+        };
+        std::vector<Band> bands;
+        PrepareColorEffect(effect, value);
         for (Mesh& m : mesh) {
-            if (!m.image || (m.image->GetTexture() == -1))
+            if (!m.image)
                 continue;
             if (m.imageOwner) {
-                Image* img = 0;
-                if (effect == RESET)
-                    img = new Image(m.image->GetName());
+                Band band;
+                band.image = m.image;
+                band.mask = maskPool[image2mask[m.image]].data();
+                for (band.y = 0; band.y < m.image->GetHeight(); band.y += Journal::kTileSize)
+                    bands.push_back(band);
+            }
+        }
+        Parallel(bands.size(), [this, &bands](unsigned long i) {
+            Band& b = bands[i];
+            int width = b.image->GetWidth();
+            int stride = (width + 31) / 32;
+            int y2 = glm::min(b.y + Journal::kTileSize, b.image->GetHeight());
+            unsigned char original[Journal::kTileSize * Journal::kTileSize * 3];
+            for (int x = 0; x < width; x += Journal::kTileSize) {
+                //skip tiles without selected texels
+                int x2 = glm::min(x + Journal::kTileSize, width);
+                bool selected = false;
+                for (int y = b.y; (y < y2) && !selected; y++)
+                    for (int w = x / 32; (w < (x2 + 31) / 32) && !selected; w++)
+                        if (b.mask[y * stride + w])
+                            selected = true;
+                if (!selected)
+                    continue;
 
-                int c, r, g, b, index = 0;
-                unsigned char* data = m.image->GetData();
-                mask = texture2mask[m.image->GetTexture()];
-                for (unsigned int i = 0; i < m.image->GetWidth() * m.image->GetHeight(); i++) {
-                    r = data[index++];
-                    g = data[index++];
-                    b = data[index++];
-                    //effects implementation
-                    if (mask[i]) {
-                        if (effect == GAMMA) {
-                            r += value;
-                            g += value;
-                            b += value;
-                        }
-                        else if ((effect == CONTRAST) || (effect == SATURATION)) {
-                            c = effect == CONTRAST ? 128 : (r + g + b) / 3;
-                            r -= (int) ((c - r) * fValue * 2.0f);
-                            g -= (int) ((c - g) * fValue * 2.0f);
-                            b -= (int) ((c - b) * fValue * 2.0f);
-                        }
-                        else if (effect == RESET) {
-                            r = img->GetData()[index - 3];
-                            g = img->GetData()[index - 2];
-                            b = img->GetData()[index - 1];
-                        }
-                        else if (effect == TONE) {
-                            float factor = 255.0f * (fValue > 0.0 ? 3.0f : -3.0f);
-                            double hue = fabs(fValue);
-                            if ((hue >= 0.0) && (hue < 0.15))
-                                r += (hue - 0.0) * factor;
-                            if ((hue >= 0.15) && (hue < 0.3))
-                                r += (0.3 - hue) * factor;
-                            if ((hue >= 0.15) && (hue < 0.3))
-                                g += (hue - 0.15) * factor;
-                            if ((hue >= 0.3) && (hue < 0.45))
-                                g += (0.45 - hue) * factor;
-                            if ((hue >= 0.3) && (hue < 0.45))
-                                b += (hue - 0.3) * factor;
-                            if ((hue >= 0.45) && (hue < 0.6))
-                                b += (0.6 - hue) * factor;
-                        }
-                        if (r < 0) r = 0;
-                        if (g < 0) g = 0;
-                        if (b < 0) b = 0;
-                        if (r > 255) r = 255;
-                        if (g > 255) g = 255;
-                        if (b > 255) b = 255;
-                        data[index - 3] = (unsigned char) r;
-                        data[index - 2] = (unsigned char) g;
-                        data[index - 1] = (unsigned char) b;
-                    }
+                //tile which was never changed does not need to be reset
+                JournalTile tile;
+                tile.image = b.image;
+                tile.x = x / Journal::kTileSize;
+                tile.y = b.y / Journal::kTileSize;
+                const JournalTile* o = journal.GetOriginal(tile.image, tile.x, tile.y);
+                if (colorEffect == RESET) {
+                    if (!o)
+                        continue;
+                    Journal::Unpack(*o, original);
                 }
-                if (img)
-                    delete img;
-                m.image->UpdateTexture();
+
+                //store tile state for undo
+                Journal::Pack(tile);
+                if (!o)
+                    b.originals.push_back(tile);
+                b.changed.push_back(tile);
+                ApplyColorRows(b.image->GetData(), b.mask, width, x, x2, b.y, y2, original);
             }
+        });
+        JournalStep step;
+        for (Band& b : bands) {
+            for (JournalTile& t : b.originals)
+                journal.AddOriginal(t);
+            step.tiles.insert(step.tiles.end(), b.changed.begin(), b.changed.end());
         }
+        if (!step.tiles.empty())
+            journal.Add(step);
+        //evicted textures drop stale compressed data too and upload the edited texels later
+        for (Mesh& m : mesh)
+            if (m.image && m.imageOwner)
+                m.image->UpdateTexture();
 
-        //cleanup
-        for (std::pair<const long, bool *> & m : texture2mask)
-            delete[] m.second;
-        texture2mask.clear();
+        //masks stay in maskPool for the next apply
+        image2mask.clear();
     }
 
-    void Effector::ApplyGeometryEffect(std::vector<Mesh> &mesh, Effector::Effect effect, float value, int axis) {
-        for (Mesh& m : mesh) {
-            long size = m.vertices.size();
-            //set axis to fit with view
-            if ((effect == MOVE) || (effect == ROTATE)) {
-                int a = 1;
-                float s = glm::sin(pitch);
-                float c = glm::cos(pitch);
-                glm::vec3 null = glm::vec3(0);
-                for (long i = 0; i < size; i++)
-                    RotateVertex(m.vertices[i], null, a, s, c);
-            }
-
-            if (effect == CLONE) {
-                for (long i = 0; i < size; i += 3) {
-                    if (m.colors[i] == 0) {
-                        //front face
-                        for (int k = 0; k < 3; k++) {
-                            m.colors.push_back(DESELECT_COLOR);
-                            m.normals.push_back(m.normals[i + k]);
-                            m.uv.push_back(m.uv[i + k]);
-                            m.vertices.push_back(m.vertices[i + k]);
+    void Effector::ApplyColorRows(unsigned char* data, unsigned int* mask, int width, int x1, int x2,
+                                  int y1, int y2, unsigned char* original) {
+        int stride = (width + 31) / 32;
+        for (int y = y1; y < y2; y++) {
+            for (int w = x1 / 32; w < (x2 + 31) / 32; w++) {
+                //skip 32 texels which are not selected at once
+                unsigned int bits = mask[y * stride + w];
+                if (!bits)
+                    continue;
+                //saturation of 8 selected texels in a row is vectorized
+                if (colorEffect == SATURATION) {
+                    for (int part = 0; part < 32; part += 8) {
+                        int x = w * 32 + part;
+                        if ((((bits >> part) & 0xFF) == 0xFF) && (x + 8 <= x2)) {
+                            SaturateRun(data + (y * width + x) * 3, saturation);
+                            bits &= ~(0xFFu << part);
                         }
-                        //back face
-                        for (int k = 2; k >= 0; k--) {
-                            m.colors.push_back(DESELECT_COLOR);
-                            m.normals.push_back(m.normals[i + k]);
-                            m.uv.push_back(m.uv[i + k]);
-                            m.vertices.push_back(m.vertices[i + k]);
-                        }
-                    }
-                }
-            } else if (effect == DELETE) {
-                std::vector<glm::vec3> vertices;
-                std::vector<glm::vec3> normals;
-                std::vector<unsigned int> colors;
-                std::vector<glm::vec2> uv;
-                for (long i = 0; i < size; i++) {
-                    if (m.colors[i] != 0) {
-                        colors.push_back(m.colors[i]);
-                        normals.push_back(m.normals[i]);
-                        uv.push_back(m.uv[i]);
-                        vertices.push_back(m.vertices[i]);
                     }
                 }
-                m.colors = colors;
-                m.normals = normals;
-                m.uv = uv;
-                m.vertices = vertices;
-            } else if (effect == MOVE) {
-                for (long i = 0; i < size; i++) {
-                    if (m.colors[i] == 0) {
-                        if (axis == 0)
-                            m.vertices[i].x += value * 10.0f / 255.0f;
-                        if (axis == 1)
-                            m.vertices[i].y += value * 10.0f / 255.0f;
-                        if (axis == 2)
-                            m.vertices[i].z += value * 10.0f / 255.0f;
+                while (bits) {
+                    int x = w * 32 + __builtin_ctz(bits);
+                    bits &= bits - 1;
+                    unsigned char* texel = data + (y * width + x) * 3;
+                    if (colorEffect == RESET) {
+                        unsigned char* o = original + ((y - y1) * (x2 - x1) + x - x1) * 3;
+                        texel[0] = o[0];
+                        texel[1] = o[1];
+                        texel[2] = o[2];
+                    } else if (colorEffect == SATURATION) {
+                        int c = (texel[0] + texel[1] + texel[2]) / 3;
+                        texel[0] = (unsigned char) SaturateTexel(texel[0], c, saturation);
+                        texel[1] = (unsigned char) SaturateTexel(texel[1], c, saturation);
+                        texel[2] = (unsigned char) SaturateTexel(texel[2], c, saturation);
+                    } else {
+                        texel[0] = lut[0][texel[0]];
+                        texel[1] = lut[1][texel[1]];
+                        texel[2] = lut[2][texel[2]];
                     }
                 }
-            } else if (effect == ROTATE) {
-                float s = (float) glm::sin(value / 255.0 * 6.28);
-                float c = (float) glm::cos(value / 255.0 * 6.28);
-                for (long i = 0; i < size; i++)
+            }
+        }
+    }
+
+    void Effector::ApplyGeometryEffect(std::vector<Mesh> &mesh, Effector::Effect effect, float value, int axis,
+                                       GLFeedback* gpu) {
+        JournalStep step;
+        if (effect == CLONE)
+            step.type = JournalStep::APPEND;
+        else if (effect == DELETE)
+            step.type = JournalStep::REMOVE;
+        else {
+            step.type = JournalStep::TRANSFORM;
+            step.transform = GetTransform(effect, value, axis);
+        }
+        bool baked = gpu && (step.type == JournalStep::TRANSFORM);
+
+        //submeshes are independent, edit them in parallel
+        std::vector<JournalMesh> data(mesh.size());
+        Parallel(mesh.size(), [&mesh, &data, &step, effect, baked](unsigned long index) {
+            Mesh& m = mesh[index];
+            JournalMesh& d = data[index];
+            d.index = index;
+            d.ranges = Journal::Selected(m);
+            if (d.ranges.empty())
+                return;
+            long size = m.vertices.size();
+            if (effect == CLONE) {
+                //count cloned triangles first to append without reallocation
+                long count = 0;
+                for (long i = 0; i < size; i += 3)
                     if (m.colors[i] == 0)
-                        RotateVertex(m.vertices[i], center, axis, s, c);
-            } else if (effect == SCALE) {
-                for (long i = 0; i < size; i++) {
+                        count += 6;
+                m.colors.reserve(size + count);
+                m.normals.reserve(size + count);
+                m.uv.reserve(size + count);
+                m.vertices.reserve(size + count);
+                for (long i = 0; i < size; i += 3) {
                     if (m.colors[i] == 0) {
-                        m.vertices[i].x -= center.x;
-                        m.vertices[i].y -= center.y;
-                        m.vertices[i].z -= center.z;
-                        if (value > 0) {
-                            m.vertices[i].x *= value / 255.0f + 1.0f;
-                            m.vertices[i].y *= value / 255.0f + 1.0f;
-                            m.vertices[i].z *= value / 255.0f + 1.0f;
-                        } else {
-                            m.vertices[i].x /= 1.0f - value / 255.0f;
-                            m.vertices[i].y /= 1.0f - value / 255.0f;
-                            m.vertices[i].z /= 1.0f - value / 255.0f;
+                        //front face and back face
+                        for (int k = 0; k < 6; k++) {
+                            long v = i + (k < 3 ? k : 5 - k);
+                            m.colors.push_back(DESELECT_COLOR);
+                            m.normals.push_back(m.normals[v]);
+                            m.uv.push_back(m.uv[v]);
+                            m.vertices.push_back(m.vertices[v]);
                         }
-                        m.vertices[i].x += center.x;
-                        m.vertices[i].y += center.y;
-                        m.vertices[i].z += center.z;
                     }
                 }
+                d.ranges.assign(1, std::pair<unsigned long, unsigned long>(size, size + count));
+            } else if (effect == DELETE) {
+                //keep removed vertices for undo and compact the rest in place
+                Journal::Remove(m, d.ranges, &d);
+            } else if (!baked) {
+                //MOVE, ROTATE and SCALE are one matrix applied on selected vertices only
+                Journal::Transform(m, d.ranges, step.transform);
             }
-
-            //set axis to fit with model
-            if ((effect == MOVE) || (effect == ROTATE)) {
-                int a = 1;
-                float s = glm::sin(-pitch);
-                float c = glm::cos(-pitch);
-                glm::vec3 null = glm::vec3(0);
-                for (long i = 0; i < size; i++)
-                    RotateVertex(m.vertices[i], null, a, s, c);
-            }
-        }
+        });
+        //GL context is bound to the calling thread, the result is read back by GLFeedback::Finish later
+        if (baked)
+            for (JournalMesh& d : data)
+                if (!d.ranges.empty() && !gpu->Begin(mesh[d.index], d.ranges, step.transform))
+                    Journal::Transform(mesh[d.index], d.ranges, step.transform);
+        for (JournalMesh& d : data)
+            if (!d.ranges.empty())
+                step.meshes.push_back(std::move(d));
+        if (!step.meshes.empty())
+            journal.Add(step);
     }
 
-    void Effector::PreviewColorEffect(std::string &fs, Effector::Effect effect) {
-        if (effect == CONTRAST) {
-            fs = "uniform sampler2D u_texture;\n"
-                    "uniform float u_uniform;\n"
-                    "varying vec4 f_color;\n"
-                    "varying vec2 v_uv;\n"
-                    "void main() {\n"
-                    "  gl_FragColor = texture2D(u_texture, v_uv) - f_color;\n"
-                    "  if (f_color.r < 0.005)\n"
-                    "  {\n"
-                    "    float c = 0.5;\n"
-                    "    gl_FragColor.r -= (c - gl_FragColor.r) * u_uniform * 2.0;\n"
-                    "    gl_FragColor.g -= (c - gl_FragColor.g) * u_uniform * 2.0;\n"
-                    "    gl_FragColor.b -= (c - gl_FragColor.b) * u_uniform * 2.0;\n"
-                    "  }\n"
-                    "}";
-        }
-        if (effect == GAMMA) {
-            fs = "uniform sampler2D u_texture;\n"
-                    "uniform float u_uniform;\n"
-                    "varying vec4 f_color;\n"
-                    "varying vec2 v_uv;\n"
-                    "void main() {\n"
-                    "  gl_FragColor = texture2D(u_texture, v_uv) - f_color;\n"
-                    "  if (f_color.r < 0.005)\n"
-                    "    gl_FragColor.rgb += u_uniform;\n"
-                    "}";
+    glm::mat4 Effector::GetTransform(Effector::Effect effect, float value, int axis) {
+        glm::mat4 edit(1);
+        if (effect == MOVE)
+            edit[3][axis] = value * 10.0f / 255.0f;
+        if (effect == ROTATE) {
+            float s = (float) glm::sin(value / 255.0 * 6.28);
+            float c = (float) glm::cos(value / 255.0 * 6.28);
+            edit = glm::translate(glm::mat4(1), center) * GetRotation(axis, s, c) * glm::translate(glm::mat4(1), -center);
         }
-        if (effect == SATURATION) {
-            fs = "uniform sampler2D u_texture;\n"
-                    "uniform float u_uniform;\n"
-                    "varying vec4 f_color;\n"
-                    "varying vec2 v_uv;\n"
-                    "void main() {\n"
-                    "  gl_FragColor = texture2D(u_texture, v_uv) - f_color;\n"
-                    "  if (f_color.r < 0.005)\n"
-                    "  {\n"
-                    "    float c = (gl_FragColor.r + gl_FragColor.g + gl_FragColor.b) / 3.0;\n"
-                    "    gl_FragColor.r -= (c - gl_FragColor.r) * u_uniform * 2.0;\n"
-                    "    gl_FragColor.g -= (c - gl_FragColor.g) * u_uniform * 2.0;\n"
-                    "    gl_FragColor.b -= (c - gl_FragColor.b) * u_uniform * 2.0;\n"
-                    "  }\n"
-                    "}";
+        if (effect == SCALE) {
+            float k = value > 0 ? value / 255.0f + 1.0f : 1.0f / (1.0f - value / 255.0f);
+            edit = glm::translate(glm::mat4(1), center) * glm::scale(glm::mat4(1), glm::vec3(k)) *
+                   glm::translate(glm::mat4(1), -center);
+            return edit;
         }
+
+        //MOVE and ROTATE are done in view aligned axes
+        glm::mat4 view = GetRotation(1, glm::sin(pitch), glm::cos(pitch));
+        glm::mat4 model = GetRotation(1, glm::sin(-pitch), glm::cos(-pitch));
+        return model * edit * view;
+    }
+
+    glm::mat4 Effector::GetRotation(int axis, float s, float c) {
+        //the same rotation as the preview shader does (glm matrices are column major)
+        glm::mat4 output(1);
+        int a = axis == 0 ? 1 : 0;
+        int b = axis == 2 ? 1 : 2;
+        output[a][a] = c;
+        output[b][a] = -s;
+        output[a][b] = s;
+        output[b][b] = c;
+        return output;
+    }
+
+    void Effector::PrepareColorEffect(Effector::Effect effect, float value) {
+        colorEffect = effect;
+        float fValue = value / 255.0f;
+        saturation = (int) (fValue * 2.0f * 65536.0f);
+
+        //per channel offset of TONE effect
+        double tone[3] = {0, 0, 0};
         if (effect == TONE) {
-            fs = "uniform sampler2D u_texture;\n"
-                    "uniform float u_uniform;\n"
-                    "varying vec4 f_color;\n"
-                    "varying vec2 v_uv;\n"
-                    "void main() {\n"
-                    "  gl_FragColor = texture2D(u_texture, v_uv) - f_color;\n"
-                    "  if (f_color.r < 0.005)\n"
-                    "  {\n"
-                    "    float factor = u_uniform > 0.0 ? 3.0 : -3.0;\n"
-                    "    float hue = abs(u_uniform);\n"
-                    "    if ((hue >= 0.0) && (hue < 0.15))\n"
-                    "      gl_FragColor.r += (hue - 0.0) * factor;\n"
-                    "    if ((hue >= 0.15) && (hue < 0.3))\n"
-                    "      gl_FragColor.r += (0.3 - hue) * factor;\n"
-                    "    if ((hue >= 0.15) && (hue < 0.3))\n"
-                    "      gl_FragColor.g += (hue - 0.15) * factor;\n"
-                    "    if ((hue >= 0.3) && (hue < 0.45))\n"
-                    "      gl_FragColor.g += (0.45 - hue) * factor;\n"
-                    "    if ((hue >= 0.3) && (hue < 0.45))\n"
-                    "      gl_FragColor.b += (hue - 0.3) * factor;\n"
-                    "    if ((hue >= 0.45) && (hue < 0.6))\n"
-                    "      gl_FragColor.b += (0.6 - hue) * factor;\n"
-                    "  }\n"
-                    "}";
+            float factor = 255.0f * (fValue > 0.0 ? 3.0f : -3.0f);
+            double hue = fabs(fValue);
+            if ((hue >= 0.0) && (hue < 0.15))
+                tone[0] = (hue - 0.0) * factor;
+            if ((hue >= 0.15) && (hue < 0.3))
+                tone[0] = (0.3 - hue) * factor;
+            if ((hue >= 0.15) && (hue < 0.3))
+                tone[1] = (hue - 0.15) * factor;
+            if ((hue >= 0.3) && (hue < 0.45))
+                tone[1] = (0.45 - hue) * factor;
+            if ((hue >= 0.3) && (hue < 0.45))
+                tone[2] = (hue - 0.3) * factor;
+            if ((hue >= 0.45) && (hue < 0.6))
+                tone[2] = (0.6 - hue) * factor;
+        }
+
+        for (int channel = 0; channel < 3; channel++) {
+            for (int i = 0; i < 256; i++) {
+                int v = i;
+                if (effect == GAMMA)
+                    v = (int) (i + value);
+                else if (effect == CONTRAST)
+                    v = i - (int) ((128 - i) * fValue * 2.0f);
+                else if (effect == TONE)
+                    v = (int) (i + tone[channel]);
+                lut[channel][i] = (unsigned char) (v < 0 ? 0 : (v > 255 ? 255 : v));
+            }
         }
     }
 
-    void Effector::PreviewGeometryEffect(std::string &vs, Effector::Effect effect, int axis) {
-        vs = "attribute vec4 v_vertex;\n"
+    void Effector::PreviewShaders(std::string &vs, std::string &fs) {
+        //effect ids are shared with the shader, effect and axis are set by uniforms
+        std::ostringstream ss;
+        ss << "#define CONTRAST " << CONTRAST << "\n";
+        ss << "#define GAMMA " << GAMMA << "\n";
+        ss << "#define SATURATION " << SATURATION << "\n";
+        ss << "#define TONE " << TONE << "\n";
+        ss << "#define MOVE " << MOVE << "\n";
+        ss << "#define ROTATE " << ROTATE << "\n";
+        ss << "#define SCALE " << SCALE << "\n";
+        std::string defines = ss.str();
+
+        fs = defines +
+             "uniform sampler2D u_texture;\n"
+             "uniform float u_uniform;\n"
+             "uniform mediump int u_effect;\n"
+             "varying vec4 f_color;\n"
+             "varying vec2 v_uv;\n"
+             "void main() {\n"
+             "  gl_FragColor = texture2D(u_texture, v_uv) - f_color;\n"
+             "  if (f_color.r < 0.005)\n"
+             "  {\n"
+             "    if (u_effect == CONTRAST)\n"
+             "      gl_FragColor.rgb -= (0.5 - gl_FragColor.rgb) * u_uniform * 2.0;\n"
+             "    if (u_effect == GAMMA)\n"
+             "      gl_FragColor.rgb += u_uniform;\n"
+             "    if (u_effect == SATURATION)\n"
+             "    {\n"
+             "      float c = (gl_FragColor.r + gl_FragColor.g + gl_FragColor.b) / 3.0;\n"
+             "      gl_FragColor.rgb -= (c - gl_FragColor.rgb) * u_uniform * 2.0;\n"
+             "    }\n"
+             "    if (u_effect == TONE)\n"
+             "    {\n"
+             "      float factor = u_uniform > 0.0 ? 3.0 : -3.0;\n"
+             "      float hue = abs(u_uniform);\n"
+             "      if ((hue >= 0.0) && (hue < 0.15))\n"
+             "        gl_FragColor.r += (hue - 0.0) * factor;\n"
+             "      if ((hue >= 0.15) && (hue < 0.3))\n"
+             "        gl_FragColor.r += (0.3 - hue) * factor;\n"
+             "      if ((hue >= 0.15) && (hue < 0.3))\n"
+             "        gl_FragColor.g += (hue - 0.15) * factor;\n"
+             "      if ((hue >= 0.3) && (hue < 0.45))\n"
+             "        gl_FragColor.g += (0.45 - hue) * factor;\n"
+             "      if ((hue >= 0.3) && (hue < 0.45))\n"
+             "        gl_FragColor.b += (hue - 0.3) * factor;\n"
+             "      if ((hue >= 0.45) && (hue < 0.6))\n"
+             "        gl_FragColor.b += (0.6 - hue) * factor;\n"
+             "    }\n"
+             "  }\n"
+             "}";
+
+        vs = defines +
+             "attribute vec4 v_vertex;\n"
              "attribute vec2 v_coord;\n"
              "attribute vec4 v_color;\n"
              "varying vec4 f_color;\n"
@@ -300,53 +397,39 @@ namespace oc {
              "uniform float u_uniform;\n"
              "uniform float u_uniformPitch;\n"
              "uniform vec3 u_uniformPos;\n"
+             "uniform mediump int u_effect;\n"
+             "uniform mediump int u_axis;\n"
+             "vec3 rotate(vec3 p, int axis, float s, float c) {\n"
+             "  if (axis == 0)\n"
+             "    return vec3(p.x, p.y * c - p.z * s, p.y * s + p.z * c);\n"
+             "  if (axis == 1)\n"
+             "    return vec3(p.x * c - p.z * s, p.y, p.x * s + p.z * c);\n"
+             "  return vec3(p.x * c - p.y * s, p.x * s + p.y * c, p.z);\n"
+             "}\n"
              "void main() {\n"
              "  f_color = v_color;\n"
              "  v_uv.x = v_coord.x;\n"
              "  v_uv.y = 1.0 - v_coord.y;\n"
              "  vec4 v = v_vertex;\n"
-             "  vec3 p = v.xyz;\n"
-             "  float s = sin(u_uniformPitch);\n"
-             "  float c = cos(u_uniformPitch);\n"
-             "  v.x = p.x * c - p.z * s;\n"
-             "  v.z = p.x * s + p.z * c;\n"
-             "  v.xyz -= u_uniformPos;\n"
              "  if (f_color.r < 0.005)\n"
-             "  {\n";
-        if (effect == MOVE) {
-            if (axis == 0)
-                vs += "    v.x += u_uniform * 10.0;\n";
-            if (axis == 1)
-                vs += "    v.y += u_uniform * 10.0;\n";
-            if (axis == 2)
-                vs += "    v.z += u_uniform * 10.0;\n";
-        }
-        if (effect == ROTATE) {
-            vs += "    s = sin(u_uniform * 6.28);\n"
-                  "    c = cos(u_uniform * 6.28);\n"
-                  "    p = v.xyz;\n";
-            if (axis == 0)
-                vs += "    v.y = p.y * c - p.z * s;\n"
-                      "    v.z = p.y * s + p.z * c;\n";
-            if (axis == 1)
-                vs += "    v.x = p.x * c - p.z * s;\n"
-                      "    v.z = p.x * s + p.z * c;\n";
-            if (axis == 2)
-                vs += "    v.x = p.x * c - p.y * s;\n"
-                      "    v.y = p.x * s + p.y * c;\n";
-        }
-        if (effect == SCALE) {
-            vs += "    v.xyz *= u_uniform > 0.0 ? u_uniform + 1.0 : 1.0 / (1.0 - u_uniform);\n";
-        }
-        vs += "  }\n"
-              "  v.xyz += u_uniformPos;\n"
-              "  p = v.xyz;\n"
-              "  s = sin(-u_uniformPitch);\n"
-              "  c = cos(-u_uniformPitch);\n"
-              "  v.x = p.x * c - p.z * s;\n"
-              "  v.z = p.x * s + p.z * c;\n"
-              "  gl_Position = MVP * v;\n"
-              "}";
+             "  {\n"
+             "    if (u_effect == SCALE)\n"
+             "    {\n"
+             "      float k = u_uniform > 0.0 ? u_uniform + 1.0 : 1.0 / (1.0 - u_uniform);\n"
+             "      v.xyz = (v.xyz - u_uniformPos) * k + u_uniformPos;\n"
+             "    }\n"
+             "    if ((u_effect == MOVE) || (u_effect == ROTATE))\n"
+             "    {\n"
+             "      vec3 p = rotate(v.xyz, 1, sin(u_uniformPitch), cos(u_uniformPitch)) - u_uniformPos;\n"
+             "      if (u_effect == MOVE)\n"
+             "        p += u_uniform * 10.0 * vec3(u_axis == 0 ? 1.0 : 0.0, u_axis == 1 ? 1.0 : 0.0, u_axis == 2 ? 1.0 : 0.0);\n"
+             "      if (u_effect == ROTATE)\n"
+             "        p = rotate(p, u_axis, sin(u_uniform * 6.28), cos(u_uniform * 6.28));\n"
+             "      v.xyz = rotate(p + u_uniformPos, 1, sin(-u_uniformPitch), cos(-u_uniformPitch));\n"
+             "    }\n"
+             "  }\n"
+             "  gl_Position = MVP * v;\n"
+             "}";
     }
 
     void Effector::Process(unsigned long &index, int &x1, int &x2, int &y, double &z1, double &z2) {
@@ -356,37 +439,29 @@ namespace oc {
         int finish = x2 + 2;
         if (finish >= viewport_width)
             finish = viewport_width - 1;
+        if (start > finish)
+            return;
+
+        //bit masks of the first and the last word of the span
+        int first = start / 32;
+        int last = finish / 32;
+        unsigned int head = 0xFFFFFFFFu << (start % 32);
+        unsigned int tail = 0xFFFFFFFFu >> (31 - finish % 32);
 
         for (int i = -2; i <= 2; i++) {
             if (y + i < 0)
                 continue;
             if (y + i >= viewport_height)
                 continue;
-            int offset = (y + i) * viewport_width;
-            for (int x = start; x <= finish; x++)
-                mask[x + offset] = true;
-        }
-    }
-
-    void Effector::RotateVertex(glm::vec3 &v, glm::vec3 &center, int &axis, float &s, float &c) {
-        v.x -= center.x;
-        v.y -= center.y;
-        v.z -= center.z;
-        glm::vec3 p = v;
-        if (axis == 0) {
-            v.y = p.y * c - p.z * s;
-            v.z = p.y * s + p.z * c;
-        }
-        if (axis == 1) {
-            v.x = p.x * c - p.z * s;
-            v.z = p.x * s + p.z * c;
-        }
-        if (axis == 2) {
-            v.x = p.x * c - p.y * s;
-            v.y = p.x * s + p.y * c;
+            unsigned int* row = mask + (y + i) * maskStride;
+            if (first == last) {
+                row[first] |= head & tail;
+            } else {
+                row[first] |= head;
+                for (int w = first + 1; w < last; w++)
+                    row[w] = 0xFFFFFFFFu;
+                row[last] |= tail;
+            }
         }
-        v.x += center.x;
-        v.y += center.y;
-        v.z += center.z;
     }
-}
\ No newline at end of file
+}
@@ -3,6 +3,8 @@
 
 #include <map>
 #include "data/mesh.h"
+#include "editor/journal.h"
+#include "gl/feedback.h"
 #include "rasterizer.h"
 
 namespace oc {
@@ -11,23 +13,34 @@ class Effector : Rasterizer {
 public:
     enum Effect{ CONTRAST, GAMMA, SATURATION, TONE, RESET, CLONE, DELETE, MOVE, ROTATE, SCALE };
 
-    void ApplyEffect(std::vector<Mesh>& mesh, Effect e, float value, int axis);
-    void PreviewEffect(std::string& vs, std::string& fs, Effect e, int axis);
+    void ApplyEffect(std::vector<Mesh>& mesh, Effect e, float value, int axis, GLFeedback* gpu = 0);
+    void Clear() { journal.Clear(); }
+    void PreviewShaders(std::string& vs, std::string& fs);
+    bool Redo(std::vector<Mesh>& mesh) { return journal.Redo(mesh); }
+    bool Undo(std::vector<Mesh>& mesh) { return journal.Undo(mesh); }
     void SetCenter(glm::vec3 value) { center = value; }
     void SetPitch(float value) { pitch = value; }
 
 private:
     void ApplyColorEffect(std::vector<Mesh>& mesh, Effect effect, float value);
-    void ApplyGeometryEffect(std::vector<Mesh>& mesh, Effect effect, float value, int axis);
-    void PreviewColorEffect(std::string& fs, Effect effect);
-    void PreviewGeometryEffect(std::string& vs, Effect effect, int axis);
+    void ApplyColorRows(unsigned char* data, unsigned int* mask, int width, int x1, int x2, int y1, int y2,
+                        unsigned char* original);
+    void ApplyGeometryEffect(std::vector<Mesh>& mesh, Effect effect, float value, int axis, GLFeedback* gpu);
+    glm::mat4 GetRotation(int axis, float s, float c);
+    glm::mat4 GetTransform(Effect effect, float value, int axis);
+    void PrepareColorEffect(Effect effect, float value);
     virtual void Process(unsigned long& index, int &x1, int &x2, int &y, double &z1, double &z2);
-    void RotateVertex(glm::vec3& v, glm::vec3& center, int& axis, float& s, float& c);
 
     glm::vec3 center;
-    bool* mask;
+    Effect colorEffect;                                ///< Color effect being applied
+    unsigned char lut[3][256];                         ///< Per channel table for GAMMA, CONTRAST and TONE
+    int saturation;                                    ///< Saturation factor in 16.16 fixed point
+    Journal journal;                                   ///< Undo history and original texture tiles
+    unsigned int* mask;                                ///< Current mask, 1 bit per texel
+    int maskStride;                                    ///< Mask words per texture row
+    std::vector<std::vector<unsigned int> > maskPool;  ///< Mask storage reused across applies
     float pitch;
-    std::map<long, bool*> texture2mask;
+    std::map<Image*, unsigned int> image2mask;         ///< Texture to index into maskPool
 };
 }
 
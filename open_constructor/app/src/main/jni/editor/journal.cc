@@ -0,0 +1,300 @@
+#include <algorithm>
+#include <cstring>
+#include <set>
+#include <zlib.h>
+#include "data/parallel.h"
+#include "editor/journal.h"
+#include "gl/opengl.h"
+
+namespace {
+    typedef float floats4 __attribute__((vector_size(16)));
+
+    void TransformRun(glm::vec3* data, unsigned long count, const glm::mat4& matrix, bool normal) {
+        //matrix columns are multiplied by vector coordinates four lanes at once
+        floats4 c0 = {matrix[0][0], matrix[0][1], matrix[0][2], 0};
+        floats4 c1 = {matrix[1][0], matrix[1][1], matrix[1][2], 0};
+        floats4 c2 = {matrix[2][0], matrix[2][1], matrix[2][2], 0};
+        floats4 c3 = {matrix[3][0], matrix[3][1], matrix[3][2], 0};
+        for (unsigned long i = 0; i < count; i++) {
+            glm::vec3& v = data[i];
+            floats4 r = c0 * v.x + c1 * v.y + c2 * v.z + c3;
+            if (normal) {
+                floats4 l = r * r;
+                float length = glm::sqrt(l[0] + l[1] + l[2]);
+                if (length > 0)
+                    r /= length;
+            }
+            v.x = r[0];
+            v.y = r[1];
+            v.z = r[2];
+        }
+    }
+
+    template<class T> void InsertRanges(std::vector<T>& data, const oc::JournalRanges& ranges,
+                                        const std::vector<T>& removed) {
+        //move kept items behind every range and fill the range, from the last range
+        unsigned long next = data.size() + removed.size();
+        unsigned long shift = removed.size();
+        data.resize(next);
+        for (long i = ranges.size() - 1; i >= 0; i--) {
+            unsigned long begin = ranges[i].first;
+            unsigned long end = ranges[i].second;
+            std::copy_backward(data.begin() + end - shift, data.begin() + next - shift, data.begin() + next);
+            shift -= end - begin;
+            std::copy(removed.begin() + shift, removed.begin() + shift + end - begin, data.begin() + begin);
+            next = begin;
+        }
+    }
+
+    template<class T> void RemoveRanges(std::vector<T>& data, const oc::JournalRanges& ranges,
+                                        std::vector<T>* removed, unsigned long count) {
+        //move kept items between ranges to the front, order is kept
+        if (removed)
+            removed->reserve(count);
+        unsigned long write = ranges.empty() ? data.size() : ranges[0].first;
+        for (unsigned long i = 0; i < ranges.size(); i++) {
+            if (removed)
+                for (unsigned long j = ranges[i].first; j < ranges[i].second; j++)
+                    removed->push_back(data[j]);
+            unsigned long begin = ranges[i].second;
+            unsigned long end = i + 1 < ranges.size() ? ranges[i + 1].first : data.size();
+            for (unsigned long j = begin; j < end; j++)
+                data[write++] = data[j];
+        }
+        data.resize(write);
+    }
+
+    template<class T> void Tail(std::vector<T>& data, unsigned long begin, std::vector<T>& output) {
+        output.assign(data.begin() + begin, data.end());
+        data.resize(begin);
+    }
+
+    template<class T> void Append(std::vector<T>& data, std::vector<T>& input) {
+        data.insert(data.end(), input.begin(), input.end());
+        std::vector<T>().swap(input);
+    }
+}
+
+namespace oc {
+
+    const unsigned long kJournalLimit = 32 * 1024 * 1024;
+    const int Journal::kTileSize;
+
+    Journal::Journal() : memory(0) {}
+
+    void Journal::Add(JournalStep& step) {
+        for (JournalStep& s : redo)
+            memory -= Size(s);
+        redo.clear();
+
+        //step over the limit cannot be undone, older steps would not fit the edited meshes anymore
+        unsigned long size = Size(step);
+        if (size > kJournalLimit) {
+            LOGI("Journal step of %lu bytes is not undoable, history cleared", size);
+            undo.clear();
+            memory = 0;
+            return;
+        }
+        undo.push_back(std::move(step));
+        memory += size;
+        Trim();
+    }
+
+    void Journal::AddOriginal(JournalTile& tile) {
+        //originals are bounded by the textures of the model, they are not counted with the steps so that
+        //reset is never lossy
+        originals[tile.image][std::pair<int, int>(tile.x, tile.y)] = tile;
+    }
+
+    void Journal::Clear() {
+        undo.clear();
+        redo.clear();
+        originals.clear();
+        memory = 0;
+    }
+
+    const JournalTile* Journal::GetOriginal(Image* image, int x, int y) {
+        std::map<Image*, std::map<std::pair<int, int>, JournalTile> >::const_iterator i;
+        i = originals.find(image);
+        if (i == originals.end())
+            return 0;
+        std::map<std::pair<int, int>, JournalTile>::const_iterator j;
+        j = i->second.find(std::pair<int, int>(x, y));
+        if (j == i->second.end())
+            return 0;
+        return &j->second;
+    }
+
+    bool Journal::Redo(std::vector<Mesh>& mesh) {
+        if (redo.empty())
+            return false;
+        Process(redo.back(), mesh, false);
+        undo.push_back(std::move(redo.back()));
+        redo.pop_back();
+        Trim();
+        return true;
+    }
+
+    bool Journal::Undo(std::vector<Mesh>& mesh) {
+        if (undo.empty())
+            return false;
+        Process(undo.back(), mesh, true);
+        redo.push_back(std::move(undo.back()));
+        undo.pop_back();
+        Trim();
+        return true;
+    }
+
+    void Journal::Insert(Mesh& mesh, const JournalMesh& data) {
+        InsertRanges(mesh.colors, data.ranges, data.colors);
+        InsertRanges(mesh.normals, data.ranges, data.normals);
+        InsertRanges(mesh.uv, data.ranges, data.uv);
+        InsertRanges(mesh.vertices, data.ranges, data.vertices);
+    }
+
+    void Journal::Pack(JournalTile& tile) {
+        int width = tile.image->GetWidth();
+        int x = tile.x * kTileSize;
+        int y = tile.y * kTileSize;
+        int w = glm::min(kTileSize, width - x);
+        int h = glm::min(kTileSize, tile.image->GetHeight() - y);
+
+        //copy texels of the tile into continuous memory
+        unsigned char raw[kTileSize * kTileSize * 3];
+        for (int i = 0; i < h; i++)
+            memcpy(raw + i * w * 3, tile.image->GetData() + ((y + i) * width + x) * 3, (size_t) (w * 3));
+
+        uLongf size = compressBound((uLong) (w * h * 3));
+        tile.data.resize(size);
+        compress2(tile.data.data(), &size, raw, (uLong) (w * h * 3), Z_BEST_SPEED);
+        tile.data.resize(size);
+    }
+
+    void Journal::Remove(Mesh& mesh, const JournalRanges& ranges, JournalMesh* removed) {
+        unsigned long count = 0;
+        for (const std::pair<unsigned long, unsigned long>& r : ranges)
+            count += r.second - r.first;
+        RemoveRanges(mesh.colors, ranges, removed ? &removed->colors : 0, count);
+        RemoveRanges(mesh.normals, ranges, removed ? &removed->normals : 0, count);
+        RemoveRanges(mesh.uv, ranges, removed ? &removed->uv : 0, count);
+        RemoveRanges(mesh.vertices, ranges, removed ? &removed->vertices : 0, count);
+    }
+
+    JournalRanges Journal::Selected(Mesh& mesh) {
+        JournalRanges output;
+        unsigned long size = mesh.colors.size();
+        for (unsigned long i = 0; i < size; i++) {
+            if (mesh.colors[i] != 0)
+                continue;
+            unsigned long begin = i;
+            while ((i < size) && (mesh.colors[i] == 0))
+                i++;
+            output.push_back(std::pair<unsigned long, unsigned long>(begin, i));
+        }
+        return output;
+    }
+
+    void Journal::Transform(Mesh& mesh, const JournalRanges& ranges, const glm::mat4& matrix) {
+        glm::mat4 normalMatrix = glm::mat4(glm::transpose(glm::inverse(glm::mat3(matrix))));
+        bool normals = mesh.normals.size() == mesh.vertices.size();
+        for (const std::pair<unsigned long, unsigned long>& r : ranges) {
+            TransformRun(mesh.vertices.data() + r.first, r.second - r.first, matrix, false);
+            if (normals)
+                TransformRun(mesh.normals.data() + r.first, r.second - r.first, normalMatrix, true);
+        }
+    }
+
+    void Journal::Unpack(const JournalTile& tile, unsigned char* output) {
+        int w = glm::min(kTileSize, tile.image->GetWidth() - tile.x * kTileSize);
+        int h = glm::min(kTileSize, tile.image->GetHeight() - tile.y * kTileSize);
+        uLongf size = (uLongf) (w * h * 3);
+        uncompress(output, &size, tile.data.data(), (uLong) tile.data.size());
+    }
+
+    void Journal::Process(JournalStep& step, std::vector<Mesh>& mesh, bool undo) {
+        memory -= Size(step);
+        if (step.type == JournalStep::TEXTURE)
+            Swap(step);
+        for (JournalMesh& m : step.meshes) {
+            Mesh& target = mesh[m.index];
+            if (step.type == JournalStep::TRANSFORM) {
+                Transform(target, m.ranges, undo ? glm::inverse(step.transform) : step.transform);
+            } else if (step.type == JournalStep::REMOVE) {
+                if (undo)
+                    Insert(target, m);
+                else
+                    Remove(target, m.ranges);
+            } else if (step.type == JournalStep::APPEND) {
+                //appended data are kept only while the step can be redone
+                if (undo) {
+                    Tail(target.colors, m.ranges[0].first, m.colors);
+                    Tail(target.normals, m.ranges[0].first, m.normals);
+                    Tail(target.uv, m.ranges[0].first, m.uv);
+                    Tail(target.vertices, m.ranges[0].first, m.vertices);
+                } else {
+                    Append(target.colors, m.colors);
+                    Append(target.normals, m.normals);
+                    Append(target.uv, m.uv);
+                    Append(target.vertices, m.vertices);
+                }
+            }
+        }
+        memory += Size(step);
+    }
+
+    unsigned long Journal::Size(JournalStep& step) {
+        unsigned long output = 0;
+        for (JournalTile& t : step.tiles)
+            output += t.data.size();
+        for (JournalMesh& m : step.meshes) {
+            output += m.ranges.size() * sizeof(std::pair<unsigned long, unsigned long>);
+            output += m.colors.size() * sizeof(unsigned int);
+            output += m.normals.size() * sizeof(glm::vec3);
+            output += m.uv.size() * sizeof(glm::vec2);
+            output += m.vertices.size() * sizeof(glm::vec3);
+        }
+        return output;
+    }
+
+    void Journal::Swap(JournalStep& step) {
+        Parallel(step.tiles.size(), [&step](unsigned long i) {
+            JournalTile& tile = step.tiles[i];
+            JournalTile current;
+            current.image = tile.image;
+            current.x = tile.x;
+            current.y = tile.y;
+            Pack(current);
+
+            //write stored texels into the image
+            unsigned char raw[kTileSize * kTileSize * 3];
+            Unpack(tile, raw);
+            int width = tile.image->GetWidth();
+            int x = tile.x * kTileSize;
+            int y = tile.y * kTileSize;
+            int w = glm::min(kTileSize, width - x);
+            int h = glm::min(kTileSize, tile.image->GetHeight() - y);
+            for (int j = 0; j < h; j++)
+                memcpy(tile.image->GetData() + ((y + j) * width + x) * 3, raw + j * w * 3, (size_t) (w * 3));
+            tile.data.swap(current.data);
+        });
+
+        std::set<Image*> updated;
+        for (JournalTile& t : step.tiles)
+            updated.insert(t.image);
+        for (Image* image : updated)
+            image->UpdateTexture();
+    }
+
+    void Journal::Trim() {
+        //forget the oldest steps to keep the memory bounded, undo can make a step grow over the limit alone
+        while ((memory > kJournalLimit) && (undo.size() + redo.size() > 0)) {
+            if (!undo.empty()) {
+                memory -= Size(undo.front());
+                undo.pop_front();
+            } else {
+                memory -= Size(redo.front());
+                redo.erase(redo.begin());
+            }
+        }
+    }
+}
@@ -0,0 +1,72 @@
+#ifndef EDITOR_JOURNAL_H
+#define EDITOR_JOURNAL_H
+
+#include <deque>
+#include <map>
+#include <vector>
+#include "data/image.h"
+#include "data/mesh.h"
+
+namespace oc {
+
+typedef std::vector<std::pair<unsigned long, unsigned long> > JournalRanges;
+
+struct JournalMesh {
+    unsigned long index;             ///< Index of the submesh
+    JournalRanges ranges;            ///< Edited vertex ranges as [begin, end), sorted
+    std::vector<glm::vec3> vertices; ///< Removed (or appended) vertices of the ranges
+    std::vector<glm::vec3> normals;  ///< Removed (or appended) normals of the ranges
+    std::vector<unsigned int> colors;///< Removed (or appended) colors of the ranges
+    std::vector<glm::vec2> uv;       ///< Removed (or appended) uvs of the ranges
+};
+
+struct JournalTile {
+    Image* image;                    ///< Texture containing the tile
+    int x, y;                        ///< Tile position in tile units
+    std::vector<unsigned char> data; ///< Compressed RGB texels of the tile
+};
+
+struct JournalStep {
+    enum Type { TEXTURE, TRANSFORM, REMOVE, APPEND };
+
+    JournalStep() : type(TEXTURE) {}
+
+    Type type;                       ///< Kind of the edit
+    glm::mat4 transform;             ///< Transformation applied on ranges by TRANSFORM step
+    std::vector<JournalMesh> meshes; ///< Geometry changed by the step
+    std::vector<JournalTile> tiles;  ///< Texture tiles state before (or after) the step
+};
+
+class Journal {
+public:
+    static const int kTileSize = 64;
+
+    Journal();
+    void Add(JournalStep& step);
+    void AddOriginal(JournalTile& tile);
+    void Clear();
+    const JournalTile* GetOriginal(Image* image, int x, int y);
+    bool Redo(std::vector<Mesh>& mesh);
+    bool Undo(std::vector<Mesh>& mesh);
+
+    static void Insert(Mesh& mesh, const JournalMesh& data);
+    static void Pack(JournalTile& tile);
+    static void Remove(Mesh& mesh, const JournalRanges& ranges, JournalMesh* removed = 0);
+    static JournalRanges Selected(Mesh& mesh);
+    static void Transform(Mesh& mesh, const JournalRanges& ranges, const glm::mat4& matrix);
+    static void Unpack(const JournalTile& tile, unsigned char* output);
+
+private:
+    void Process(JournalStep& step, std::vector<Mesh>& mesh, bool undo);
+    unsigned long Size(JournalStep& step);
+    void Swap(JournalStep& step);
+    void Trim();
+
+    std::deque<JournalStep> undo;                                        ///< Steps to undo, the newest last
+    std::vector<JournalStep> redo;                                       ///< Steps to redo, the newest last
+    std::map<Image*, std::map<std::pair<int, int>, JournalTile> > originals; ///< Tiles as they were loaded
+    unsigned long memory;                                                ///< Memory used by steps
+};
+}
+
+#endif
@@ -1,6 +1,7 @@
 #ifndef EDITOR_RASTERIZER_H
 #define EDITOR_RASTERIZER_H
 
+#include <vector>
 #include "gl/opengl.h"
 
 namespace oc {
@@ -1,6 +1,7 @@
 #ifndef EDITOR_SELECTOR_H
 #define EDITOR_SELECTOR_H
 
+#include <map>
 #include "data/mesh.h"
 #include "editor/rasterizer.h"
 
@@ -0,0 +1,205 @@
+#include <cstring>
+#include "gl/feedback.h"
+#include "gl/glsl.h"
+
+#ifdef ANDROID
+#include <GLES3/gl3.h>
+#endif
+
+std::string FeedbackFragmentShader() {
+  return "#version 300 es\n"
+         "precision mediump float;\n"
+         "out vec4 color;\n"
+         "void main() {\n"
+         "  color = vec4(0.0);\n"
+         "}\n";
+}
+
+std::string FeedbackVertexShader() {
+  return "#version 300 es\n"
+         "layout(location = 0) in vec3 v_vertex;\n"
+         "layout(location = 1) in vec3 v_normal;\n"
+         "uniform mat4 u_matrix;\n"
+         "uniform mat3 u_normalMatrix;\n"
+         "out vec3 f_vertex;\n"
+         "out vec3 f_normal;\n"
+         "void main() {\n"
+         "  f_vertex = (u_matrix * vec4(v_vertex, 1.0)).xyz;\n"
+         "  vec3 n = u_normalMatrix * v_normal;\n"
+         "  f_normal = length(n) > 0.0 ? normalize(n) : n;\n"
+         "  gl_Position = vec4(0.0);\n"
+         "}\n";
+}
+
+namespace oc {
+    GLFeedback::GLFeedback() {
+        std::string vs = FeedbackVertexShader();
+        std::string fs = FeedbackFragmentShader();
+        const char* vsp = vs.c_str();
+        const char* fsp = fs.c_str();
+        shader_vp = glCreateShader(GL_VERTEX_SHADER);
+        shader_fp = glCreateShader(GL_FRAGMENT_SHADER);
+        glShaderSource(shader_vp, 1, &vsp, 0);
+        glShaderSource(shader_fp, 1, &fsp, 0);
+
+        /// Alocate buffer for logs
+        const unsigned int BUFFER_SIZE = 512;
+        char buffer[BUFFER_SIZE];
+        memset(buffer, 0, BUFFER_SIZE);
+        GLsizei length = 0;
+
+        /// Compile shaders
+        glCompileShader(shader_vp);
+        glGetShaderInfoLog(shader_vp, BUFFER_SIZE, &length, buffer);
+        if (length > 0)
+            LOGI("GLSL compile log: %s\n%s", buffer, vsp);
+        glCompileShader(shader_fp);
+        glGetShaderInfoLog(shader_fp, BUFFER_SIZE, &length, buffer);
+        if (length > 0)
+            LOGI("GLSL compile log: %s\n%s", buffer, fsp);
+
+        /// Link program, captured varyings have to be set before linking
+        id = glCreateProgram();
+        glAttachShader(id, shader_fp);
+        glAttachShader(id, shader_vp);
+        const char* varyings[] = {"f_vertex", "f_normal"};
+        glTransformFeedbackVaryings(id, 2, varyings, GL_INTERLEAVED_ATTRIBS);
+        glLinkProgram(id);
+        glGetProgramInfoLog(id, BUFFER_SIZE, &length, buffer);
+        if (length > 0)
+            LOGI("GLSL program info log: %s", buffer);
+        GLint status;
+        glGetProgramiv(id, GL_LINK_STATUS, &status);
+        linked = status != GL_FALSE;
+        if (!linked)
+            LOGI("GLSL error linking");
+
+        glGenBuffers(2, buffers);
+        fence = 0;
+    }
+
+    GLFeedback::~GLFeedback() {
+        for (FeedbackJob& job : jobs)
+            glDeleteBuffers(1, &job.buffer);
+        if (fence)
+            glDeleteSync((GLsync)fence);
+        glDeleteBuffers(2, buffers);
+        glDetachShader(id, shader_vp);
+        glDetachShader(id, shader_fp);
+        glDeleteShader(shader_vp);
+        glDeleteShader(shader_fp);
+        glDeleteProgram(id);
+    }
+
+    bool GLFeedback::IsSupported() {
+        const char* version = (const char*)glGetString(GL_VERSION);
+        return version && (strstr(version, "OpenGL ES 3") != 0);
+    }
+
+    bool GLFeedback::Begin(Mesh& mesh, const FeedbackRanges& ranges, const glm::mat4& matrix) {
+        if (ranges.empty())
+            return true;
+        if (!linked)
+            return false;
+
+        //upload only the span covering all ranges
+        FeedbackJob job;
+        job.mesh = &mesh;
+        job.ranges = ranges;
+        job.matrix = matrix;
+        job.begin = ranges.front().first;
+        job.count = ranges.back().second - job.begin;
+        job.normals = mesh.normals.size() == mesh.vertices.size();
+        glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(matrix)));
+        glUseProgram(id);
+        glUniformMatrix4fv(glGetUniformLocation(id, "u_matrix"), 1, GL_FALSE, glm::value_ptr(matrix));
+        glUniformMatrix3fv(glGetUniformLocation(id, "u_normalMatrix"), 1, GL_FALSE, glm::value_ptr(normalMatrix));
+        glBindBuffer(GL_ARRAY_BUFFER, buffers[0]);
+        glBufferData(GL_ARRAY_BUFFER, job.count * sizeof(glm::vec3), &mesh.vertices[job.begin], GL_STREAM_DRAW);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, 0);
+        if (job.normals) {
+            glBindBuffer(GL_ARRAY_BUFFER, buffers[1]);
+            glBufferData(GL_ARRAY_BUFFER, job.count * sizeof(glm::vec3), &mesh.normals[job.begin], GL_STREAM_DRAW);
+            glEnableVertexAttribArray(1);
+            glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 0, 0);
+        } else
+            glVertexAttrib3f(1, 0, 0, 0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        //transform the span without rasterizing anything
+        while (glGetError() != GL_NO_ERROR);
+        glGenBuffers(1, &job.buffer);
+        glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, job.buffer);
+        glBufferData(GL_TRANSFORM_FEEDBACK_BUFFER, job.count * 2 * sizeof(glm::vec3), 0, GL_STREAM_READ);
+        glEnable(GL_RASTERIZER_DISCARD);
+        glBeginTransformFeedback(GL_POINTS);
+        glDrawArrays(GL_POINTS, 0, (GLsizei) job.count);
+        glEndTransformFeedback();
+        glDisable(GL_RASTERIZER_DISCARD);
+        glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+        bool ok = glGetError() == GL_NO_ERROR;
+
+        //restore state expected by GLSL
+        glDisableVertexAttribArray(0);
+        glDisableVertexAttribArray(1);
+        if (GLSL::CurrentShader())
+            GLSL::CurrentShader()->Unbind();
+        if (!ok) {
+            glDeleteBuffers(1, &job.buffer);
+            return false;
+        }
+
+        //the fence after the last job covers all of them
+        if (fence)
+            glDeleteSync((GLsync)fence);
+        fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        glFlush();
+        jobs.push_back(job);
+        return true;
+    }
+
+    bool GLFeedback::Finish(FeedbackFallback fallback) {
+        if (jobs.empty())
+            return true;
+        GLenum status = glClientWaitSync((GLsync)fence, 0, 0);
+        if (status == GL_TIMEOUT_EXPIRED)
+            return false;
+
+        //read back selected vertices only
+        for (FeedbackJob& job : jobs) {
+            glm::vec3* output = 0;
+            glBindBuffer(GL_TRANSFORM_FEEDBACK_BUFFER, job.buffer);
+            if (status != GL_WAIT_FAILED)
+                output = (glm::vec3*)glMapBufferRange(GL_TRANSFORM_FEEDBACK_BUFFER, 0,
+                                                      job.count * 2 * sizeof(glm::vec3), GL_MAP_READ_BIT);
+            if (output) {
+                Mesh& mesh = *job.mesh;
+                for (const std::pair<unsigned long, unsigned long>& r : job.ranges) {
+                    for (unsigned long i = r.first; i < r.second; i++) {
+                        mesh.vertices[i] = output[(i - job.begin) * 2 + 0];
+                        if (job.normals)
+                            mesh.normals[i] = output[(i - job.begin) * 2 + 1];
+                    }
+                }
+                glUnmapBuffer(GL_TRANSFORM_FEEDBACK_BUFFER);
+            } else {
+                LOGE("GLFeedback readback failed");
+                fallback(*job.mesh, job.ranges, job.matrix);
+            }
+            glBindBuffer(GL_TRANSFORM_FEEDBACK_BUFFER, 0);
+            glDeleteBuffers(1, &job.buffer);
+        }
+        glDeleteSync((GLsync)fence);
+        fence = 0;
+        jobs.clear();
+        return true;
+    }
+
+    void GLFeedback::Abandon(FeedbackFallback fallback) {
+        for (FeedbackJob& job : jobs)
+            fallback(*job.mesh, job.ranges, job.matrix);
+        fence = 0;
+        jobs.clear();
+    }
+}
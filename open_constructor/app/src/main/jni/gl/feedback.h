@@ -0,0 +1,74 @@
+#ifndef GL_FEEDBACK_H
+#define GL_FEEDBACK_H
+
+#include <functional>
+#include <vector>
+#include "data/mesh.h"
+#include "gl/opengl.h"
+
+namespace oc {
+    typedef std::vector<std::pair<unsigned long, unsigned long> > FeedbackRanges;
+    typedef std::function<void(Mesh&, const FeedbackRanges&, const glm::mat4&)> FeedbackFallback;
+
+    struct FeedbackJob {
+        Mesh* mesh;               ///< Mesh which gets the result
+        FeedbackRanges ranges;    ///< Vertex ranges as [begin, end) to be transformed, sorted
+        glm::mat4 matrix;         ///< Transformation matrix
+        unsigned long begin;      ///< First vertex of the uploaded span
+        unsigned long count;      ///< Amount of vertices in the uploaded span
+        bool normals;             ///< Normals were transformed too
+        unsigned int buffer;      ///< Captured output
+    };
+
+    class GLFeedback {
+    public:
+        /**
+         * @brief Constructor, it has to be called on thread with GLES3 context
+         */
+        GLFeedback();
+
+        ~GLFeedback();
+
+        /**
+         * @brief IsSupported checks if current context is able to do transform feedback
+         * @return true if GLES3 is available
+         */
+        static bool IsSupported();
+
+        /**
+         * @brief Begin starts transforming vertices and normals of mesh on GPU, the mesh is changed
+         * by Finish on a later frame, it must not be edited or destroyed meanwhile
+         * @param mesh is mesh to be transformed
+         * @param ranges are vertex ranges as [begin, end) to be transformed, sorted
+         * @param matrix is transformation matrix
+         * @return false if the transformation could not be started and mesh will not be changed
+         */
+        bool Begin(Mesh& mesh, const FeedbackRanges& ranges, const glm::mat4& matrix);
+
+        /**
+         * @brief Finish writes results into meshes if GPU is done, it never waits for GPU
+         * @param fallback transforms a mesh on CPU when its result could not be read back
+         * @return true if no transformation is pending anymore
+         */
+        bool Finish(FeedbackFallback fallback);
+
+        /**
+         * @brief Abandon transforms pending meshes on CPU without any GL call, it is used when
+         * the GL thread is not running, GL objects of the jobs are left to the context
+         * @param fallback transforms a mesh on CPU
+         */
+        void Abandon(FeedbackFallback fallback);
+
+        bool IsPending() { return !jobs.empty(); }
+
+    private:
+        unsigned int id;          ///< Program id
+        unsigned int shader_vp;   ///< Vertex shader
+        unsigned int shader_fp;   ///< Fragment shader
+        unsigned int buffers[2];  ///< Vertices and normals
+        bool linked;              ///< Program was linked successfully
+        void* fence;              ///< Sync object signaled after the last job
+        std::vector<FeedbackJob> jobs; ///< Transformations waiting for readback
+    };
+}
+#endif
@@ -0,0 +1,169 @@
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <map>
+#include "data/etc1.h"
+#include "gl/textures.h"
+
+#ifndef GL_ETC1_RGB8_OES
+#define GL_ETC1_RGB8_OES 0x8D64
+#endif
+#ifndef GL_COMPRESSED_RGB8_ETC2
+#define GL_COMPRESSED_RGB8_ETC2 0x9274
+#endif
+
+namespace {
+    const unsigned long kFrameBytes = 4 * 1024 * 1024;
+    const long kFrameMicroseconds = 4000;
+
+    struct TextureEntry {
+        oc::Image* image;    ///< Image which the texture was created from
+        unsigned long bytes; ///< GPU memory used by the texture
+        unsigned long frame; ///< Frame when the texture was drawn the last time
+    };
+
+    unsigned long textures_frameBytes = 0;
+    std::chrono::steady_clock::time_point textures_frameStart;
+    GLuint textures_placeholder = 0;
+    std::map<GLuint, TextureEntry> textures_entries;
+    unsigned long textures_budget = 256 * 1024 * 1024;
+    unsigned long textures_frame = 0;
+    unsigned long textures_memory = 0;
+
+    bool IsGLES3() {
+        const char* version = (const char*)glGetString(GL_VERSION);
+        return version && (strstr(version, "OpenGL ES 3") != 0);
+    }
+}
+
+namespace oc {
+    bool GLTextures::IsCompressionSupported() {
+        const char* extensions = (const char*)glGetString(GL_EXTENSIONS);
+        bool etc1 = extensions && (strstr(extensions, "GL_OES_compressed_ETC1_RGB8_texture") != 0);
+        return etc1 || IsGLES3();
+    }
+
+    unsigned long GLTextures::GetMemory() {
+        return textures_memory;
+    }
+
+    void GLTextures::NewFrame() {
+        textures_frame++;
+        textures_frameBytes = 0;
+        textures_frameStart = std::chrono::steady_clock::now();
+
+        //textures of changed or destroyed images are deleted at once
+        std::vector<GLuint> unused = Image::TexturesToDelete();
+        for (GLuint id : unused) {
+            std::map<GLuint, TextureEntry>::iterator i = textures_entries.find(id);
+            if (i != textures_entries.end()) {
+                textures_memory -= i->second.bytes;
+                textures_entries.erase(i);
+            }
+        }
+
+        //over the budget evict the least recently drawn textures, they are uploaded again when drawn
+        if (textures_memory > textures_budget) {
+            std::vector<std::pair<unsigned long, GLuint> > candidates;
+            for (std::pair<const GLuint, TextureEntry>& i : textures_entries)
+                if (i.second.frame + 1 < textures_frame)
+                    candidates.push_back(std::pair<unsigned long, GLuint>(i.second.frame, i.first));
+            std::sort(candidates.begin(), candidates.end());
+            unsigned long evicted = unused.size();
+            for (std::pair<unsigned long, GLuint>& c : candidates) {
+                if (textures_memory <= textures_budget)
+                    break;
+                TextureEntry& entry = textures_entries[c.second];
+                entry.image->SetTexture(-1);
+                textures_memory -= entry.bytes;
+                textures_entries.erase(c.second);
+                unused.push_back(c.second);
+            }
+            if (unused.size() > evicted)
+                LOGI("Evicted %d textures, %luMB used", (int)(unused.size() - evicted), textures_memory >> 20);
+        }
+        if (!unused.empty())
+            glDeleteTextures((GLsizei) unused.size(), unused.data());
+    }
+
+    unsigned int GLTextures::Placeholder() {
+        if (!textures_placeholder) {
+            unsigned char grey[] = {128, 128, 128};
+            glGenTextures(1, &textures_placeholder);
+            glBindTexture(GL_TEXTURE_2D, textures_placeholder);
+            glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+            glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, 1, 1, 0, GL_RGB, GL_UNSIGNED_BYTE, grey);
+        }
+        return textures_placeholder;
+    }
+
+    void GLTextures::SetBudget(unsigned long bytes) {
+        textures_budget = bytes;
+    }
+
+    bool GLTextures::Upload(Image* image) {
+        //the first texture of the frame is always uploaded so that loading does not stall
+        std::vector<std::vector<unsigned char> >& levels = image->GetCompressed();
+        bool compressed = !levels.empty() && IsCompressionSupported();
+        unsigned long size = (unsigned long) (image->GetWidth() * image->GetHeight() * 3);
+        if (compressed) {
+            size = 0;
+            for (std::vector<unsigned char>& l : levels)
+                size += l.size();
+        }
+        if (textures_frameBytes > 0) {
+            long elapsed = (long) std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - textures_frameStart).count();
+            if ((textures_frameBytes + size > kFrameBytes) || (elapsed > kFrameMicroseconds))
+                return false;
+        }
+        textures_frameBytes += size;
+
+        GLuint textureID;
+        glGenTextures(1, &textureID);
+        image->SetTexture(textureID);
+        TextureEntry entry;
+        entry.image = image;
+        entry.bytes = size;
+        entry.frame = textures_frame;
+        textures_entries[textureID] = entry;
+        textures_memory += size;
+        glBindTexture(GL_TEXTURE_2D, textureID);
+        glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+        if (!compressed) {
+            glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, image->GetWidth(), image->GetHeight(),
+                         0, GL_RGB, GL_UNSIGNED_BYTE, image->GetData());
+            return true;
+        }
+
+        //ETC1 data are valid ETC2, GLES2 does not allow mipmaps on non power of two textures
+        int w = image->GetWidth();
+        int h = image->GetHeight();
+        bool gles3 = IsGLES3();
+        GLenum format = gles3 ? GL_COMPRESSED_RGB8_ETC2 : GL_ETC1_RGB8_OES;
+        bool mipmaps = gles3 || (((w & (w - 1)) == 0) && ((h & (h - 1)) == 0));
+        unsigned long count = mipmaps ? levels.size() : 1;
+        glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, count > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+        for (unsigned long i = 0; i < count; i++) {
+            glCompressedTexImage2D(GL_TEXTURE_2D, (GLint) i, format, w, h, 0,
+                                   (GLsizei) ETC1::Size(w, h), levels[i].data());
+            w = w > 1 ? w / 2 : 1;
+            h = h > 1 ? h / 2 : 1;
+        }
+        return true;
+    }
+
+    unsigned int GLTextures::Use(Image* image) {
+        std::map<GLuint, TextureEntry>::iterator i = textures_entries.find((GLuint) image->GetTexture());
+        if ((image->GetTexture() == -1) || (i == textures_entries.end()))
+            return Placeholder();
+        i->second.frame = textures_frame;
+        return (unsigned int) image->GetTexture();
+    }
+}
@@ -0,0 +1,56 @@
+#ifndef GL_TEXTURES_H
+#define GL_TEXTURES_H
+
+#include "data/image.h"
+#include "gl/opengl.h"
+
+namespace oc {
+    class GLTextures {
+    public:
+        /**
+         * @brief GetMemory gives GPU memory used by uploaded textures
+         * @return size in bytes
+         */
+        static unsigned long GetMemory();
+
+        /**
+         * @brief IsCompressionSupported checks if current context can sample ETC1 textures
+         * @return true if ETC1 extension or GLES3 is available
+         */
+        static bool IsCompressionSupported();
+
+        /**
+         * @brief NewFrame resets upload budget, deletes unused textures and evicts textures over memory
+         * budget, it has to be called once per rendered frame
+         */
+        static void NewFrame();
+
+        /**
+         * @brief Placeholder gives grey texture to draw meshes whose texture was not uploaded yet
+         * @return texture id
+         */
+        static unsigned int Placeholder();
+
+        /**
+         * @brief SetBudget sets GPU memory limit of textures, textures not drawn in the last frame are
+         * evicted to keep the limit
+         * @param bytes is limit in bytes
+         */
+        static void SetBudget(unsigned long bytes);
+
+        /**
+         * @brief Upload creates texture of image, compressed mipmaps are used if they are available
+         * @param image is image to be uploaded, compressed data are kept to upload again after eviction
+         * @return false if frame budget is exhausted and upload was postponed to the next frame
+         */
+        static bool Upload(Image* image);
+
+        /**
+         * @brief Use marks texture of image as drawn in the current frame
+         * @param image is image which texture is drawn
+         * @return texture id to bind, placeholder if the texture is not uploaded
+         */
+        static unsigned int Use(Image* image);
+    };
+}
+#endif
@@ -1,17 +1,23 @@
 #include "gl/opengl.h"
+#include "gl/textures.h"
 #include "scene.h"
 
 namespace oc {
 
-    Scene::Scene() : color_vertex_shader(0), textured_shader(0), uniform(0) {
-        vertex = TexturedVertexShader();
-        fragment = TexturedFragmentShader();
+    Scene::Scene() : feedback(0), color_vertex_shader(0), textured_shader(0), uniform(0),
+                     uniformAxis(0), uniformEffect(-1) {
+        SetShader(TexturedVertexShader(), TexturedFragmentShader());
     }
 
     Scene::~Scene() {
+        delete feedback;
+        feedback = 0;
         delete color_vertex_shader;
         color_vertex_shader = 0;
-        delete textured_shader;
+        for (std::pair<const size_t, std::vector<SceneShader> >& i : shaders)
+            for (SceneShader& s : i.second)
+                delete s.program;
+        shaders.clear();
         textured_shader = 0;
     }
 
@@ -19,22 +25,30 @@ namespace oc {
         glViewport(0, 0, w, h);
         renderer = new GLRenderer();
         renderer->Init(w, h, 1);
+
+        //geometry effects are baked on GPU if the context supports it
+        delete feedback;
+        feedback = GLFeedback::IsSupported() ? new GLFeedback() : 0;
     }
 
-    void Scene::Render(bool frustum) {
+    void Scene::Precompile(const std::string& vs, const std::string& fs) {
+        size_t key = ShaderKey(vs, fs);
+        if (FindShader(key, vs, fs))
+            return;
+        shaders[key].push_back({vs, fs, new GLSL(vs, fs)});
+        if ((key == shader) && (vs == vertex) && (fs == fragment))
+            textured_shader = shaders[key].back().program;
+    }
 
-        if ((lastVertex.compare(vertex) != 0) || (lastFragment.compare(fragment) != 0))
-        {
-            delete textured_shader;
-            textured_shader = 0;
-            lastVertex = vertex;
-            lastFragment = fragment;
-        }
+    void Scene::Render(bool frustum) {
 
         if (!color_vertex_shader)
             color_vertex_shader = new GLSL(ColorVertexShader(), ColorFragmentShader());
-        if (!textured_shader)
+        if (!textured_shader) {
+            LOGI("Compiling shader which was not precompiled");
             textured_shader = new GLSL(vertex, fragment);
+            shaders[shader].push_back({vertex, fragment, textured_shader});
+        }
 
         glEnable(GL_DEPTH_TEST);
         glEnable(GL_CULL_FACE);
@@ -43,29 +57,26 @@ namespace oc {
         glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
         glClear(GL_DEPTH_BUFFER_BIT | GL_COLOR_BUFFER_BIT);
         long lastTexture = INT_MAX;
+        GLTextures::NewFrame();
         for (Mesh& mesh : static_meshes_) {
-            if (mesh.image && (mesh.image->GetTexture() == -1)) {
-                GLuint textureID;
-                glGenTextures(1, &textureID);
-                mesh.image->SetTexture(textureID);
-                glBindTexture(GL_TEXTURE_2D, textureID);
-                glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-                glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-                glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-                glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-                glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, mesh.image->GetWidth(), mesh.image->GetHeight(),
-                             0, GL_RGB, GL_UNSIGNED_BYTE, mesh.image->GetData());
-            }
-            if (!mesh.image || (mesh.image->GetTexture() == -1)) {
+            if (mesh.vertices.empty())
+                continue;
+            if (mesh.image && (mesh.image->GetTexture() == -1))
+                GLTextures::Upload(mesh.image);
+            if (!mesh.image) {
                 color_vertex_shader->Bind();
                 renderer->Render(&mesh.vertices[0].x, 0, 0, mesh.colors.data(), mesh.vertices.size());
             } else {
-                if (lastTexture != mesh.image->GetTexture()) {
-                    lastTexture = (unsigned int)mesh.image->GetTexture();
-                    glBindTexture(GL_TEXTURE_2D, (unsigned int)mesh.image->GetTexture());
+                //textures over the frame upload budget are drawn with placeholder
+                long texture = GLTextures::Use(mesh.image);
+                if (lastTexture != texture) {
+                    lastTexture = texture;
+                    glBindTexture(GL_TEXTURE_2D, (unsigned int)texture);
                 }
                 textured_shader->Bind();
                 textured_shader->UniformFloat("u_uniform", uniform);
+                textured_shader->UniformInt("u_axis", uniformAxis);
+                textured_shader->UniformInt("u_effect", uniformEffect);
                 textured_shader->UniformFloat("u_uniformPitch", uniformPitch);
                 textured_shader->UniformVec3("u_uniformPos", uniformPos.x, uniformPos.y, uniformPos.z);
                 renderer->Render(&mesh.vertices[0].x, 0, &mesh.uv[0].s, mesh.colors.data(), mesh.vertices.size());
@@ -75,9 +86,29 @@ namespace oc {
         if(!frustum_.vertices.empty() && frustum)
             renderer->Render(&frustum_.vertices[0].x, 0, 0, frustum_.colors.data(),
                              frustum_.indices.size(), frustum_.indices.data());
+    }
+
+    void Scene::SetShader(const std::string& vs, const std::string& fs) {
+        //the program is resolved once here, Render compiles it only if it was not precompiled
+        shader = ShaderKey(vs, fs);
+        vertex = vs;
+        fragment = fs;
+        textured_shader = FindShader(shader, vertex, fragment);
+    }
+
+    GLSL* Scene::FindShader(size_t key, const std::string& vs, const std::string& fs) {
+        //sources are compared, programs with colliding hashes share the bucket
+        std::unordered_map<size_t, std::vector<SceneShader> >::iterator i = shaders.find(key);
+        if (i == shaders.end())
+            return 0;
+        for (SceneShader& s : i->second)
+            if ((s.vertex == vs) && (s.fragment == fs))
+                return s.program;
+        return 0;
+    }
 
-        for (long i : Image::TexturesToDelete())
-            glDeleteTextures(1, (const GLuint *) &i);
+    size_t Scene::ShaderKey(const std::string& vs, const std::string& fs) {
+        return std::hash<std::string>()(vs) * 31 + std::hash<std::string>()(fs);
     }
 
     void Scene::UpdateFrustum(glm::vec3 pos, float zoom) {
@@ -1,19 +1,29 @@
 #ifndef SCENE_H
 #define SCENE_H
 
+#include <unordered_map>
 #include <vector>
 #include "data/file3d.h"
+#include "gl/feedback.h"
 #include "gl/glsl.h"
 #include "gl/renderer.h"
 #include "tango/scan.h"
 
 namespace oc {
+    struct SceneShader {
+        std::string vertex;    ///< Vertex shader source
+        std::string fragment;  ///< Fragment shader source
+        GLSL* program;         ///< Linked program
+    };
+
     class Scene {
     public:
         Scene();
         ~Scene();
         void SetupViewPort(int w, int h);
+        void Precompile(const std::string& vs, const std::string& fs);
         void Render(bool frustum);
+        void SetShader(const std::string& vs, const std::string& fs);
         void UpdateFrustum(glm::vec3 pos, float zoom);
 
         std::string ColorFragmentShader();
@@ -23,18 +33,24 @@ namespace oc {
 
         Mesh frustum_;
         std::vector<Mesh> static_meshes_;
+        GLFeedback* feedback;
         GLSL* color_vertex_shader;
         GLSL* textured_shader;
         GLRenderer* renderer;
 
-        std::string vertex;
-        std::string fragment;
         float uniform;
+        int uniformAxis;
+        int uniformEffect;
         float uniformPitch;
         glm::vec3 uniformPos;
     private:
-        std::string lastVertex;
-        std::string lastFragment;
+        GLSL* FindShader(size_t key, const std::string& vs, const std::string& fs);
+        static size_t ShaderKey(const std::string& vs, const std::string& fs);
+
+        std::string vertex;                           ///< Vertex shader of textured geometry
+        std::string fragment;                         ///< Fragment shader of textured geometry
+        size_t shader;                                ///< Key of the current shader in shaders
+        std::unordered_map<size_t, std::vector<SceneShader> > shaders; ///< Linked programs by hash of their source
     };
 }
 
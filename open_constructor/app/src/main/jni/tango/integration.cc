@@ -0,0 +1,106 @@
+#include "data/trace.h"
+#include "tango/integration.h"
+
+namespace oc {
+
+    TangoIntegration::TangoIntegration(unsigned int capacity) : capacity(capacity), busy(false), running(false),
+                                                                integrated(0), stale(0) {
+        //one buffer is filled by the callback and one is integrated by the worker
+        buffers.resize(capacity + 2);
+        for (IntegrationTask& t : buffers)
+            pool.push_back(&t);
+    }
+
+    TangoIntegration::~TangoIntegration() {
+        Stop();
+    }
+
+    void TangoIntegration::Start(std::function<void(IntegrationTask&)> task) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (running)
+            return;
+        this->task = task;
+        running = true;
+        worker = std::thread(&TangoIntegration::Run, this);
+    }
+
+    void TangoIntegration::Stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!running)
+                return;
+            running = false;
+            changed.notify_all();
+        }
+        worker.join();
+        Clear();
+    }
+
+    IntegrationTask* TangoIntegration::Acquire() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!pool.empty()) {
+            IntegrationTask* output = pool.back();
+            pool.pop_back();
+            return output;
+        }
+        if (queue.empty())
+            return 0;
+        IntegrationTask* output = queue.front();
+        queue.pop_front();
+        stale++;
+        return output;
+    }
+
+    void TangoIntegration::Push(IntegrationTask* task) {
+        std::lock_guard<std::mutex> lock(mutex);
+        //the worker is behind, the oldest task is not worth integrating anymore
+        if (queue.size() >= capacity) {
+            pool.push_back(queue.front());
+            queue.pop_front();
+            stale++;
+        }
+        queue.push_back(task);
+        changed.notify_all();
+    }
+
+    void TangoIntegration::Release(IntegrationTask* task) {
+        std::lock_guard<std::mutex> lock(mutex);
+        pool.push_back(task);
+    }
+
+    void TangoIntegration::Clear() {
+        std::lock_guard<std::mutex> lock(mutex);
+        while (!queue.empty()) {
+            pool.push_back(queue.front());
+            queue.pop_front();
+        }
+        changed.notify_all();
+    }
+
+    void TangoIntegration::Flush() {
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [this] { return !running || (queue.empty() && !busy); });
+    }
+
+    void TangoIntegration::Run() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            changed.wait(lock, [this] { return !running || !queue.empty(); });
+            if (!running)
+                break;
+            IntegrationTask* current = queue.front();
+            queue.pop_front();
+            busy = true;
+            lock.unlock();
+            {
+                OC_TRACE_SCOPE("TangoIntegration::Run");
+                task(*current);
+            }
+            lock.lock();
+            pool.push_back(current);
+            busy = false;
+            integrated++;
+            changed.notify_all();
+        }
+    }
+}
@@ -0,0 +1,91 @@
+#ifndef TANGO_INTEGRATION_H
+#define TANGO_INTEGRATION_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <tango_3d_reconstruction_api.h>
+#include "gl/opengl.h"
+
+namespace oc {
+
+    struct IntegrationTask {
+        std::vector<float> points;         ///< Depth points as XYZC
+        double depth_timestamp;            ///< Timestamp of the depth data
+        glm::mat4 depth_matrix;            ///< Pose of the depth camera
+        std::vector<unsigned char> image;  ///< YUV data of the color frame
+        Tango3DR_ImageBuffer image_info;   ///< Color frame description, its data points into image
+        glm::mat4 image_matrix;            ///< Pose of the color camera
+    };
+
+    class TangoIntegration {
+    public:
+        /**
+         * @param capacity is maximal amount of queued tasks, older tasks are dropped when it is reached
+         */
+        TangoIntegration(unsigned int capacity);
+        ~TangoIntegration();
+
+        /**
+         * Starts the worker thread, it does nothing when the worker is running already
+         * @param task is integration of one task, it runs on the worker thread
+         */
+        void Start(std::function<void(IntegrationTask&)> task);
+
+        /**
+         * Stops the worker after the running task, queued tasks are dropped
+         */
+        void Stop();
+
+        /**
+         * Provides a buffer for a new task, it never blocks. If all buffers are used, the oldest
+         * queued task is dropped as stale and its buffer is reused.
+         * @return buffer which has to be passed to Push or Release, null if no buffer is available
+         */
+        IntegrationTask* Acquire();
+
+        /**
+         * Queues a task filled by the caller
+         */
+        void Push(IntegrationTask* task);
+
+        /**
+         * Returns an unused buffer into the pool
+         */
+        void Release(IntegrationTask* task);
+
+        /**
+         * Drops queued tasks, a running task is finished
+         */
+        void Clear();
+
+        /**
+         * Waits until all queued tasks are integrated
+         */
+        void Flush();
+
+        unsigned long GetIntegrated() { return integrated; }
+        unsigned long GetStale() { return stale; }
+
+    private:
+        void Run();
+
+        std::vector<IntegrationTask> buffers;  ///< Pooled tasks, their storage is kept between uses
+        std::vector<IntegrationTask*> pool;    ///< Unused buffers
+        std::deque<IntegrationTask*> queue;    ///< Tasks waiting for the worker, the oldest first
+        unsigned int capacity;
+        bool busy;
+        bool running;
+        std::atomic<unsigned long> integrated;
+        std::atomic<unsigned long> stale;
+        std::function<void(IntegrationTask&)> task;
+        std::mutex mutex;
+        std::condition_variable changed;
+        std::thread worker;
+    };
+}
+#endif
@@ -0,0 +1,107 @@
+#include <sstream>
+#include "tango/pool.h"
+
+namespace oc {
+
+    const unsigned long kMaxUnused = 64;
+    const uint32_t kSmallestFaceCapacity = 256;
+
+    TangoMeshPool::TangoMeshPool() : hits(0), misses(0) {
+        for (int i = 0; i < kSizeClasses; i++)
+            allocated[i] = 0;
+    }
+
+    TangoMeshPool::~TangoMeshPool() {
+        Clear();
+    }
+
+    Tango3DR_Mesh* TangoMeshPool::Get(int size_class) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!unused[size_class].empty()) {
+                Tango3DR_Mesh* mesh = unused[size_class].back();
+                unused[size_class].pop_back();
+                hits++;
+                return mesh;
+            }
+            misses++;
+            allocated[size_class]++;
+        }
+
+        //the allocation is done outside of the lock
+        Tango3DR_Mesh* mesh = new Tango3DR_Mesh();
+        Tango3DR_Status ret = Tango3DR_Mesh_init(GetVertexCapacity(size_class), GetFaceCapacity(size_class),
+                                                 false, true, false, false, 0, 0, 0, mesh);
+        if (ret != TANGO_3DR_SUCCESS)
+            std::exit(EXIT_SUCCESS);
+        return mesh;
+    }
+
+    void TangoMeshPool::Release(Tango3DR_Mesh* mesh) {
+        int size_class = GetSizeClass(mesh->max_num_vertices, mesh->max_num_faces);
+        bool pooled = (mesh->max_num_vertices == GetVertexCapacity(size_class)) &&
+                      (mesh->max_num_faces == GetFaceCapacity(size_class));
+        if (pooled) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (unused[size_class].size() < kMaxUnused) {
+                mesh->num_vertices = 0;
+                mesh->num_faces = 0;
+                unused[size_class].push_back(mesh);
+                return;
+            }
+            allocated[size_class]--;
+        }
+        Tango3DR_Mesh_destroy(mesh);
+        delete mesh;
+    }
+
+    void TangoMeshPool::Clear() {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (int i = 0; i < kSizeClasses; i++) {
+            for (Tango3DR_Mesh* mesh : unused[i]) {
+                Tango3DR_Mesh_destroy(mesh);
+                delete mesh;
+            }
+            allocated[i] -= unused[i].size();
+            unused[i].clear();
+        }
+    }
+
+    int TangoMeshPool::GetSizeClass(uint32_t vertices, uint32_t faces) {
+        for (int i = 0; i < kSizeClasses - 1; i++)
+            if ((vertices <= GetVertexCapacity(i)) && (faces <= GetFaceCapacity(i)))
+                return i;
+        return kSizeClasses - 1;
+    }
+
+    std::string TangoMeshPool::GetStats() {
+        std::lock_guard<std::mutex> lock(mutex);
+        unsigned long count = 0;
+        unsigned long free = 0;
+        unsigned long bytes = 0;
+        for (int i = 0; i < kSizeClasses; i++) {
+            count += allocated[i];
+            free += unused[i].size();
+            //vertex position, vertex color and face indices
+            bytes += allocated[i] * (GetVertexCapacity(i) * (sizeof(Tango3DR_Vector3) + sizeof(uint32_t)) +
+                                     GetFaceCapacity(i) * sizeof(Tango3DR_Face));
+        }
+        unsigned long requests = hits + misses;
+        std::ostringstream ss;
+        ss.precision(1);
+        ss << std::fixed;
+        ss << "Mesh pool: " << requests << " requests, " << hits << " hits (";
+        ss << (requests ? hits * 100.0 / requests : 0.0) << "%), " << count << " meshes (" << free;
+        ss << " unused), " << bytes / 1048576.0 << " MB\n";
+        return ss.str();
+    }
+
+    uint32_t TangoMeshPool::GetFaceCapacity(int size_class) {
+        return kSmallestFaceCapacity << size_class;
+    }
+
+    uint32_t TangoMeshPool::GetVertexCapacity(int size_class) {
+        //a segment rarely has more vertices than twice its faces
+        return GetFaceCapacity(size_class) * 2;
+    }
+}
@@ -0,0 +1,56 @@
+#ifndef TANGO_POOL_H
+#define TANGO_POOL_H
+
+#include <mutex>
+#include <string>
+#include <vector>
+#include <tango_3d_reconstruction_api.h>
+
+namespace oc {
+
+    class TangoMeshPool {
+    public:
+        TangoMeshPool();
+        ~TangoMeshPool();
+
+        /**
+         * Provides a mesh with preallocated vertex, color and face buffers, it is thread safe
+         * @param size_class is index of the size class, the capacity doubles with every class
+         * @return mesh which has to be returned by Release
+         */
+        Tango3DR_Mesh* Get(int size_class);
+
+        /**
+         * Returns a mesh for reuse, meshes of other capacities than the size classes are destroyed
+         */
+        void Release(Tango3DR_Mesh* mesh);
+
+        /**
+         * Destroys all unused meshes
+         */
+        void Clear();
+
+        /**
+         * @return smallest size class which can hold the mesh, it is clamped to the largest class
+         */
+        static int GetSizeClass(uint32_t vertices, uint32_t faces);
+
+        /**
+         * @return human readable hit rate and memory of the pool
+         */
+        std::string GetStats();
+
+        static const int kSizeClasses = 9;
+
+    private:
+        static uint32_t GetFaceCapacity(int size_class);
+        static uint32_t GetVertexCapacity(int size_class);
+
+        std::mutex mutex;
+        std::vector<Tango3DR_Mesh*> unused[kSizeClasses]; ///< Meshes ready for reuse by size class
+        unsigned long allocated[kSizeClasses];            ///< Amount of meshes created by size class
+        unsigned long hits;
+        unsigned long misses;
+    };
+}
+#endif
@@ -0,0 +1,253 @@
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <sstream>
+#include <thread>
+#include "data/trace.h"
+#include "gl/opengl.h"
+#include "tango/replay.h"
+
+namespace {
+    const char kReplayMagic[4] = {'O', 'C', 'R', '1'};
+
+    double Elapsed(std::chrono::steady_clock::time_point since) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - since).count();
+    }
+
+    bool ReadTransform(FILE* file, int& type, double& timestamp, TangoMatrixTransformData& transform) {
+        int status;
+        if (fread(&type, sizeof(int), 1, file) != 1)
+            return false;
+        if (fread(&timestamp, sizeof(double), 1, file) != 1)
+            return false;
+        if (fread(transform.matrix, sizeof(float), 16, file) != 16)
+            return false;
+        if (fread(&status, sizeof(int), 1, file) != 1)
+            return false;
+        transform.timestamp = timestamp;
+        transform.status_code = (TangoPoseStatusType) status;
+        return true;
+    }
+}
+
+namespace oc {
+
+    TangoReplay::TangoReplay() : file(0), recording(false), replaying(false) {}
+
+    TangoReplay::~TangoReplay() {
+        StopRecording();
+    }
+
+    bool TangoReplay::StartRecording(std::string filename) {
+        StopRecording();
+        std::lock_guard<std::mutex> lock(file_mutex);
+        file = fopen(filename.c_str(), "wb");
+        if (!file) {
+            LOGE("Unable to record into %s", filename.c_str());
+            return false;
+        }
+        fwrite(kReplayMagic, 1, sizeof(kReplayMagic), file);
+        recording = true;
+        LOGI("Recording into %s", filename.c_str());
+        return true;
+    }
+
+    void TangoReplay::StopRecording() {
+        std::lock_guard<std::mutex> lock(file_mutex);
+        recording = false;
+        if (file) {
+            fclose(file);
+            file = 0;
+        }
+    }
+
+    void TangoReplay::AddPointCloud(const TangoPointCloud* cloud, const TangoMatrixTransformData& transform) {
+        if (!recording)
+            return;
+        std::lock_guard<std::mutex> lock(file_mutex);
+        if (!file)
+            return;
+        WriteHeader(POINT_CLOUD, cloud->timestamp, transform);
+        fwrite(&cloud->num_points, sizeof(uint32_t), 1, file);
+        fwrite(cloud->points, sizeof(float) * 4, cloud->num_points, file);
+    }
+
+    void TangoReplay::AddFrame(const TangoImageBuffer* buffer, const TangoMatrixTransformData& transform) {
+        if (!recording)
+            return;
+        std::lock_guard<std::mutex> lock(file_mutex);
+        if (!file)
+            return;
+        //YUV 420 semi planar, full resolution luma and half resolution chroma
+        int format = buffer->format;
+        uint32_t size = buffer->stride * buffer->height * 3 / 2;
+        WriteHeader(FRAME, buffer->timestamp, transform);
+        fwrite(&buffer->width, sizeof(uint32_t), 1, file);
+        fwrite(&buffer->height, sizeof(uint32_t), 1, file);
+        fwrite(&buffer->stride, sizeof(uint32_t), 1, file);
+        fwrite(&format, sizeof(int), 1, file);
+        fwrite(&size, sizeof(uint32_t), 1, file);
+        fwrite(buffer->data, 1, size, file);
+    }
+
+    std::string TangoReplay::Run(std::string filename, bool realtime,
+                                 std::function<void(TangoPointCloud*, TangoMatrixTransformData&)> cloud,
+                                 std::function<bool(const TangoImageBuffer*, TangoMatrixTransformData&)> frame,
+                                 std::function<void(unsigned long&, unsigned long&)> flush) {
+        FILE* input = fopen(filename.c_str(), "rb");
+        if (!input) {
+            LOGE("Unable to replay %s", filename.c_str());
+            return "Replay: unable to open " + filename;
+        }
+        char magic[sizeof(kReplayMagic)];
+        if ((fread(magic, 1, sizeof(magic), input) != sizeof(magic)) || memcmp(magic, kReplayMagic, sizeof(magic))) {
+            fclose(input);
+            LOGE("Invalid replay file %s", filename.c_str());
+            return "Replay: invalid file " + filename;
+        }
+        std::vector<ReplayRecord> records = Index(input);
+        if (records.empty()) {
+            fclose(input);
+            return "Replay: no data in " + filename;
+        }
+
+        replaying = true;
+        int clouds = 0, frames = 0, accepted = 0, dropped = 0;
+        std::vector<double> cloud_latency, frame_latency;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (unsigned long i = 0; i < records.size(); i++) {
+            ReplayRecord& r = records[i];
+            double due = r.timestamp - records[0].timestamp;
+            if (realtime) {
+                //sensors do not wait, data is dropped when newer data of the same kind is already available
+                double now = Elapsed(start);
+                if (now < due)
+                    std::this_thread::sleep_for(std::chrono::duration<double>(due - now));
+                else {
+                    bool stale = false;
+                    for (unsigned long j = i + 1; j < records.size(); j++) {
+                        if (records[j].type == r.type) {
+                            stale = records[j].timestamp - records[0].timestamp <= now;
+                            break;
+                        }
+                    }
+                    if (stale) {
+                        dropped++;
+                        continue;
+                    }
+                }
+            }
+
+            //load the record before measuring
+            int type;
+            double timestamp;
+            TangoMatrixTransformData transform;
+            fseek(input, r.offset, SEEK_SET);
+            if (!ReadTransform(input, type, timestamp, transform))
+                break;
+            TangoPointCloud point_cloud;
+            TangoImageBuffer buffer;
+            if (type == POINT_CLOUD) {
+                memset(&point_cloud, 0, sizeof(TangoPointCloud));
+                point_cloud.timestamp = timestamp;
+                if (fread(&point_cloud.num_points, sizeof(uint32_t), 1, input) != 1)
+                    break;
+                data.resize(point_cloud.num_points * sizeof(float) * 4);
+                if (fread(data.data(), 1, data.size(), input) != data.size())
+                    break;
+                point_cloud.points = (float (*)[4]) data.data();
+            } else {
+                int format;
+                uint32_t size;
+                memset(&buffer, 0, sizeof(TangoImageBuffer));
+                buffer.timestamp = timestamp;
+                if ((fread(&buffer.width, sizeof(uint32_t), 1, input) != 1) ||
+                    (fread(&buffer.height, sizeof(uint32_t), 1, input) != 1) ||
+                    (fread(&buffer.stride, sizeof(uint32_t), 1, input) != 1) ||
+                    (fread(&format, sizeof(int), 1, input) != 1) ||
+                    (fread(&size, sizeof(uint32_t), 1, input) != 1))
+                    break;
+                data.resize(size);
+                if (fread(data.data(), 1, size, input) != size)
+                    break;
+                buffer.format = (TangoImageFormatType) format;
+                buffer.data = data.data();
+            }
+
+            //in realtime the latency includes waiting for the previous callbacks
+            std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+            if (type == POINT_CLOUD) {
+                cloud(&point_cloud, transform);
+                clouds++;
+            } else {
+                if (frame(&buffer, transform))
+                    accepted++;
+                frames++;
+            }
+            double latency = realtime ? Elapsed(start) - due : Elapsed(begin);
+            (type == POINT_CLOUD ? cloud_latency : frame_latency).push_back(latency * 1000.0);
+        }
+        unsigned long integrated = 0, stale = 0;
+        flush(integrated, stale);
+        double duration = Elapsed(start);
+        replaying = false;
+        fclose(input);
+        data.clear();
+        data.shrink_to_fit();
+
+        std::ostringstream ss;
+        ss.precision(3);
+        ss << std::fixed;
+        ss << "Replay: " << clouds << " clouds, " << frames << " frames, " << dropped << " dropped in ";
+        ss << duration << " s\n";
+        ss << "Accepted " << accepted << " frames, integrated " << integrated << " and " << stale << " stale, ";
+        ss << (duration > 0 ? integrated / duration : 0) << " integrations/s\n";
+        ss << "Frame latency p50 " << Trace::Percentile(frame_latency, 50) << " ms, p95 ";
+        ss << Trace::Percentile(frame_latency, 95) << " ms, p99 " << Trace::Percentile(frame_latency, 99) << " ms\n";
+        ss << "Cloud latency p50 " << Trace::Percentile(cloud_latency, 50) << " ms, p95 ";
+        ss << Trace::Percentile(cloud_latency, 95) << " ms, p99 " << Trace::Percentile(cloud_latency, 99) << " ms";
+        LOGI("%s", ss.str().c_str());
+        return ss.str();
+    }
+
+    std::vector<ReplayRecord> TangoReplay::Index(FILE* file) {
+        //only headers are read, payloads are loaded during replay
+        std::vector<ReplayRecord> output;
+        while (true) {
+            ReplayRecord record;
+            TangoMatrixTransformData transform;
+            record.offset = ftell(file);
+            if (!ReadTransform(file, record.type, record.timestamp, transform))
+                break;
+            long skip;
+            if (record.type == POINT_CLOUD) {
+                uint32_t num_points;
+                if (fread(&num_points, sizeof(uint32_t), 1, file) != 1)
+                    break;
+                skip = (long) num_points * sizeof(float) * 4;
+            } else if (record.type == FRAME) {
+                uint32_t header[5];
+                if (fread(header, sizeof(uint32_t), 5, file) != 5)
+                    break;
+                skip = header[4];
+            } else
+                break;
+            if (fseek(file, skip, SEEK_CUR))
+                break;
+            output.push_back(record);
+        }
+        //records of the depth and color threads may interleave slightly out of order
+        std::stable_sort(output.begin(), output.end(), [](const ReplayRecord& a, const ReplayRecord& b) {
+            return a.timestamp < b.timestamp;
+        });
+        return output;
+    }
+
+    void TangoReplay::WriteHeader(int type, double timestamp, const TangoMatrixTransformData& transform) {
+        int status = transform.status_code;
+        fwrite(&type, sizeof(int), 1, file);
+        fwrite(&timestamp, sizeof(double), 1, file);
+        fwrite(transform.matrix, sizeof(float), 16, file);
+        fwrite(&status, sizeof(int), 1, file);
+    }
+}
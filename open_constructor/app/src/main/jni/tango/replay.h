@@ -0,0 +1,84 @@
+#ifndef TANGO_REPLAY_H
+#define TANGO_REPLAY_H
+
+#include <atomic>
+#include <cstdio>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <tango_client_api.h>
+#include <tango_support_api.h>
+
+namespace oc {
+
+    struct ReplayRecord {
+        int type;         ///< Kind of the record, one of TangoReplay::Record
+        double timestamp; ///< Timestamp of the sensor data in seconds
+        long offset;      ///< Position of the record in the capture file
+    };
+
+    class TangoReplay {
+    public:
+        enum Record { POINT_CLOUD = 1, FRAME = 2 };
+
+        TangoReplay();
+        ~TangoReplay();
+
+        /**
+         * Starts capturing of the sensor streams, previous capture is finished
+         * @param filename is path of the capture file
+         * @return true if the file was created
+         */
+        bool StartRecording(std::string filename);
+
+        /**
+         * Finishes the capture file
+         */
+        void StopRecording();
+
+        /**
+         * Appends a depth point cloud into the capture, it is ignored when not recording
+         * @param cloud is the depth data
+         * @param transform is the depth camera pose queried for the cloud
+         */
+        void AddPointCloud(const TangoPointCloud* cloud, const TangoMatrixTransformData& transform);
+
+        /**
+         * Appends a color frame into the capture, it is ignored when not recording
+         * @param buffer is the YUV image
+         * @param transform is the color camera pose queried for the frame
+         */
+        void AddFrame(const TangoImageBuffer* buffer, const TangoMatrixTransformData& transform);
+
+        /**
+         * Feeds a capture through the callbacks and measures them
+         * @param filename is path of the capture file
+         * @param realtime keeps the recorded timing and drops data arriving while the callbacks are busy,
+         *        otherwise the records are fed one after another as fast as possible
+         * @param cloud is called for every depth point cloud
+         * @param frame is called for every color frame, it returns true if the frame was accepted for integration
+         * @param flush is called after the last record, it waits for pending integrations and returns amount
+         *        of integrated frames and frames dropped as stale
+         * @return human readable report
+         */
+        std::string Run(std::string filename, bool realtime,
+                        std::function<void(TangoPointCloud*, TangoMatrixTransformData&)> cloud,
+                        std::function<bool(const TangoImageBuffer*, TangoMatrixTransformData&)> frame,
+                        std::function<void(unsigned long&, unsigned long&)> flush);
+
+        bool IsRecording() { return recording; }
+        bool IsReplaying() { return replaying; }
+
+    private:
+        std::vector<ReplayRecord> Index(FILE* file);
+        void WriteHeader(int type, double timestamp, const TangoMatrixTransformData& transform);
+
+        FILE* file;                       ///< Capture being recorded
+        std::mutex file_mutex;            ///< Depth and color callbacks run on different threads
+        std::atomic<bool> recording;
+        std::atomic<bool> replaying;
+        std::vector<unsigned char> data;  ///< Payload of the record being replayed
+    };
+}
+#endif
@@ -1,55 +1,223 @@
+#include <algorithm>
+#include <atomic>
+#include "data/parallel.h"
+#include "data/trace.h"
 #include "tango/scan.h"
 
 namespace oc {
 
-    const int kInitialVertexCount = 30;
-    const int kInitialFaceCount = 10;
-    const float kGrowthFactor = 1.1f;
+    //grid cells of 3DR have 16x16x16 voxels (Tango3DR_GridIndexArray), mesh segments can extend
+    //slightly beyond the cell to connect seamlessly, the bounding sphere has one voxel of margin
+    const int kSegmentVoxels = 16;
+    const float kSegmentMarginVoxels = 1;
+    const double kExtractionRate = 2;
+    const unsigned int kExtractionLimit = 64;
+    const float kViewAngle = 0.5f;
+    const double kHiddenDelay = 4;
 
     bool GridIndex::operator==(const GridIndex &o) const {
         return indices[0] == o.indices[0] && indices[1] == o.indices[1] && indices[2] == o.indices[2];
     }
 
+    TangoScan::TangoScan() : render_removed(false), last_timestamp(0), rate(kExtractionRate),
+                             limit(kExtractionLimit) {}
+
     void TangoScan::Clear() {
-        Tango3DR_Status ret;
-        for (std::pair<GridIndex, Tango3DR_Mesh*> p : meshes) {
-            ret = Tango3DR_Mesh_destroy(p.second);
-            if (ret != TANGO_3DR_SUCCESS)
-                std::exit(EXIT_SUCCESS);
-            delete p.second;
-        }
+        for (std::pair<GridIndex, Tango3DR_Mesh*> p : meshes)
+            pool.Release(p.second);
         meshes.clear();
+        segments.clear();
+        dirty.clear();
+        render_list.clear();
+        listed.clear();
+        render_removed = false;
+        pool.Clear();
     }
 
     void TangoScan::Merge(std::vector<std::pair<GridIndex, Tango3DR_Mesh*> > added) {
-        Tango3DR_Status ret;
+        OC_TRACE_SCOPE("TangoScan::Merge");
         for (std::pair<GridIndex, Tango3DR_Mesh*> p : added) {
-            if (meshes.find(p.first) != meshes.end()) {
-                ret = Tango3DR_Mesh_destroy(meshes[p.first]);
-                if (ret != TANGO_3DR_SUCCESS)
-                    std::exit(EXIT_SUCCESS);
-                delete meshes[p.first];
+            auto it = meshes.find(p.first);
+            if (it != meshes.end()) {
+                pool.Release(it->second);
+                it->second = p.second;
+            } else
+                meshes[p.first] = p.second;
+
+            //the render list is sorted by RenderList, new segments are only appended, a segment which got
+            //empty stays listed until RenderList removes it so that it cannot be appended twice
+            bool was_listed = listed.count(p.first) > 0;
+            if (!was_listed && (p.second->num_faces > 0)) {
+                render_list.push_back(std::make_pair(0.0f, p.first));
+                listed.insert(p.first);
+            } else if (was_listed && (p.second->num_faces == 0))
+                render_removed = true;
+        }
+    }
+
+    std::vector<Tango3DR_Mesh*>& TangoScan::RenderList(glm::mat4 view_projection, glm::vec3 camera,
+                                                       double resolution) {
+        if (render_removed) {
+            render_list.erase(std::remove_if(render_list.begin(), render_list.end(),
+                                             [this](const std::pair<float, GridIndex>& s) {
+                if (meshes.find(s.second)->second->num_faces > 0)
+                    return false;
+                listed.erase(s.second);
+                return true;
+            }), render_list.end());
+            render_removed = false;
+        }
+
+        //the order changes only a little between frames, insertion sort is nearly linear then
+        float cell_size = (float) (resolution * kSegmentVoxels);
+        for (std::pair<float, GridIndex>& s : render_list) {
+            glm::vec3 index = glm::vec3(s.second.indices[0], s.second.indices[1], s.second.indices[2]);
+            s.first = glm::length(camera - (index + 0.5f) * cell_size);
+        }
+        for (unsigned long i = 1; i < render_list.size(); i++) {
+            std::pair<float, GridIndex> s = render_list[i];
+            unsigned long j = i;
+            for (; (j > 0) && (render_list[j - 1].first > s.first); j--)
+                render_list[j] = render_list[j - 1];
+            render_list[j] = s;
+        }
+
+        //frustum planes of the view projection matrix, a segment is culled by its bounding sphere
+        glm::vec4 planes[6];
+        glm::mat4 m = glm::transpose(view_projection);
+        for (int i = 0; i < 3; i++) {
+            planes[i * 2 + 0] = m[3] + m[i];
+            planes[i * 2 + 1] = m[3] - m[i];
+        }
+        float radius = (cell_size * 0.5f + (float) resolution * kSegmentMarginVoxels) * glm::sqrt(3.0f);
+        render_meshes.clear();
+        for (std::pair<float, GridIndex>& s : render_list) {
+            glm::vec3 index = glm::vec3(s.second.indices[0], s.second.indices[1], s.second.indices[2]);
+            glm::vec4 centre = glm::vec4((index + 0.5f) * cell_size, 1.0f);
+            bool visible = true;
+            for (glm::vec4& plane : planes) {
+                if (glm::dot(plane, centre) < -radius * glm::length(glm::vec3(plane))) {
+                    visible = false;
+                    break;
+                }
             }
-            meshes[p.first] = p.second;
+            if (visible)
+                render_meshes.push_back(meshes.find(s.second)->second);
         }
+        return render_meshes;
     }
 
     std::vector<std::pair<GridIndex, Tango3DR_Mesh*> > TangoScan::Process(Tango3DR_ReconstructionContext context,
-                                                                          Tango3DR_GridIndexArray *t3dr_updated) {
-        Tango3DR_Status ret;
-        std::pair<GridIndex, Tango3DR_Mesh*> pair;
-        std::vector<std::pair<GridIndex, Tango3DR_Mesh*> > output;
-        for (unsigned long it = 0; it < t3dr_updated->num_indices; ++it) {
-            pair.first.indices[0] = t3dr_updated->indices[it][0];
-            pair.first.indices[1] = t3dr_updated->indices[it][1];
-            pair.first.indices[2] = t3dr_updated->indices[it][2];
-
-            pair.second = new Tango3DR_Mesh();
-            ret = Tango3DR_extractMeshSegment(context, t3dr_updated->indices[it], pair.second);
-            if (ret != TANGO_3DR_SUCCESS)
-                std::exit(EXIT_SUCCESS);
-            output.push_back(pair);
+                                                                          Tango3DR_GridIndexArray *t3dr_updated,
+                                                                          double timestamp, glm::mat4 camera,
+                                                                          double resolution) {
+        last_timestamp = timestamp;
+        for (unsigned long i = 0; i < t3dr_updated->num_indices; i++) {
+            GridIndex index;
+            index.indices[0] = t3dr_updated->indices[i][0];
+            index.indices[1] = t3dr_updated->indices[i][1];
+            index.indices[2] = t3dr_updated->indices[i][2];
+            auto it = segments.find(index);
+            if (it == segments.end())
+                it = segments.insert(std::make_pair(index, SegmentState{-1, 0})).first;
+            it->second.dirty++;
+            dirty.insert(index);
+        }
+
+        //segments in front of the camera are due sooner and go first
+        float cell_size = (float) (resolution * kSegmentVoxels);
+        glm::vec3 position = glm::vec3(camera[3]);
+        glm::vec3 direction = glm::normalize(glm::vec3(camera * glm::vec4(0, 0, 1, 0)));
+        float cos_angle = glm::cos(kViewAngle);
+        double interval = rate > 0 ? 1.0 / rate : 0;
+        std::vector<std::pair<std::pair<bool, float>, GridIndex> > due;
+        for (const GridIndex& index : dirty) {
+            glm::vec3 centre = (glm::vec3(index.indices[0], index.indices[1], index.indices[2]) + 0.5f) * cell_size;
+            glm::vec3 diff = centre - position;
+            float distance = glm::length(diff);
+            bool visible = (distance < cell_size) || (glm::dot(diff, direction) > distance * cos_angle);
+            SegmentState& state = segments[index];
+            double delay = visible ? interval : interval * kHiddenDelay;
+            if ((state.extracted >= 0) && (timestamp - state.extracted < delay))
+                continue;
+            //hidden segments are sorted behind all visible ones
+            due.push_back(std::make_pair(std::make_pair(!visible, distance), index));
         }
+        std::sort(due.begin(), due.end(), [](const std::pair<std::pair<bool, float>, GridIndex>& a,
+                                             const std::pair<std::pair<bool, float>, GridIndex>& b) {
+            return a.first < b.first;
+        });
+        if (limit && (due.size() > limit))
+            due.resize(limit);
+
+        std::vector<GridIndex> indices;
+        for (std::pair<std::pair<bool, float>, GridIndex>& p : due)
+            indices.push_back(p.second);
+        return Extract(context, indices);
+    }
+
+    std::vector<std::pair<GridIndex, Tango3DR_Mesh*> > TangoScan::Flush(Tango3DR_ReconstructionContext context) {
+        std::vector<GridIndex> indices(dirty.begin(), dirty.end());
+        return Extract(context, indices);
+    }
+
+    void TangoScan::SetRate(double rate, unsigned int limit) {
+        this->rate = rate;
+        this->limit = limit;
+    }
+
+    std::vector<std::pair<GridIndex, Tango3DR_Mesh*> > TangoScan::Extract(Tango3DR_ReconstructionContext context,
+                                                                          std::vector<GridIndex>& indices) {
+        OC_TRACE_SCOPE("TangoScan::Extract");
+        for (GridIndex& index : indices) {
+            SegmentState& state = segments[index];
+            state.extracted = last_timestamp;
+            state.dirty = 0;
+            dirty.erase(index);
+        }
+
+        //segments are independent, every task writes only its own output slot
+        std::atomic<bool> failed(false);
+        std::vector<std::pair<GridIndex, Tango3DR_Mesh*> > output(indices.size());
+        std::function<void(unsigned long)> task = [this, context, &indices, &output, &failed](unsigned long it) {
+            std::pair<GridIndex, Tango3DR_Mesh*>& pair = output[it];
+            pair.first = indices[it];
+
+            //segments grow slowly, the previous size of the segment is the best guess
+            int size_class = 0;
+            auto previous = meshes.find(pair.first);
+            if (previous != meshes.end())
+                size_class = TangoMeshPool::GetSizeClass(previous->second->num_vertices,
+                                                         previous->second->num_faces);
+
+            Tango3DR_Status ret = TANGO_3DR_INSUFFICIENT_SPACE;
+            while (ret == TANGO_3DR_INSUFFICIENT_SPACE) {
+                pair.second = pool.Get(size_class);
+                ret = Tango3DR_extractPreallocatedMeshSegment(context, pair.first.indices, pair.second);
+                if (ret == TANGO_3DR_INSUFFICIENT_SPACE) {
+                    pool.Release(pair.second);
+                    if (size_class + 1 < TangoMeshPool::kSizeClasses)
+                        size_class++;
+                    else {
+                        //the segment is larger than any size class, it is allocated exactly
+                        pair.second = new Tango3DR_Mesh();
+                        ret = Tango3DR_extractMeshSegment(context, pair.first.indices, pair.second);
+                    }
+                }
+            }
+            if (ret != TANGO_3DR_SUCCESS)
+                failed = true;
+        };
+
+        //3DR does not document extraction from one context on several threads as safe, it is opt-in
+#ifdef OC_PARALLEL_EXTRACTION
+        Parallel(indices.size(), task);
+#else
+        for (unsigned long i = 0; i < indices.size(); i++)
+            task(i);
+#endif
+        if (failed)
+            std::exit(EXIT_SUCCESS);
         return output;
     }
 }
@@ -3,8 +3,10 @@
 
 #include <tango_3d_reconstruction_api.h>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include "data/mesh.h"
+#include "tango/pool.h"
 
 namespace oc {
 
@@ -27,16 +29,68 @@ namespace oc {
         }
     };
 
+    struct SegmentState {
+        double extracted;    ///< Timestamp of the last extraction, negative if it was never extracted
+        unsigned int dirty;  ///< Amount of updates since the last extraction
+    };
+
     class TangoScan {
     public:
+        TangoScan();
         void Clear();
-        std::unordered_map<GridIndex, Tango3DR_Mesh*, GridIndexHasher> Data() { return meshes; }
+        std::string GetPoolStats() { return pool.GetStats(); }
         void Merge(std::vector<std::pair<GridIndex, Tango3DR_Mesh*> > added);
+
+        /**
+         * Marks updated segments as dirty and extracts those which are due
+         * @param context is reconstruction context with the updated segments
+         * @param t3dr_updated is list of segments changed by the last update
+         * @param timestamp is time of the update in seconds
+         * @param camera is pose of the depth camera, segments in front of it are extracted first
+         * @param resolution is size of one voxel in meters
+         * @return extracted segments which have to be passed to Merge
+         */
         std::vector<std::pair<GridIndex, Tango3DR_Mesh*> > Process(Tango3DR_ReconstructionContext context,
-                                                                   Tango3DR_GridIndexArray *t3dr_updated);
+                                                                   Tango3DR_GridIndexArray *t3dr_updated,
+                                                                   double timestamp, glm::mat4 camera,
+                                                                   double resolution);
+
+        /**
+         * Extracts all dirty segments regardless of the rate
+         * @return extracted segments which have to be passed to Merge
+         */
+        std::vector<std::pair<GridIndex, Tango3DR_Mesh*> > Flush(Tango3DR_ReconstructionContext context);
+
+        /**
+         * Provides non-empty segments inside the view sorted from the nearest to the furthest
+         * @param view_projection is transformation from the world into the clip space
+         * @param camera is position of the camera
+         * @param resolution is size of one voxel in meters
+         * @return meshes to render, the list is valid until the next call
+         */
+        std::vector<Tango3DR_Mesh*>& RenderList(glm::mat4 view_projection, glm::vec3 camera, double resolution);
+
+        /**
+         * @param rate is how many times per second one segment can be extracted
+         * @param limit is maximal amount of segments extracted by one Process call, zero for no limit
+         */
+        void SetRate(double rate, unsigned int limit);
 
     private:
+        std::vector<std::pair<GridIndex, Tango3DR_Mesh*> > Extract(Tango3DR_ReconstructionContext context,
+                                                                   std::vector<GridIndex>& indices);
+
         std::unordered_map<GridIndex, Tango3DR_Mesh*, GridIndexHasher> meshes;
+        std::unordered_map<GridIndex, SegmentState, GridIndexHasher> segments;
+        std::unordered_set<GridIndex, GridIndexHasher> dirty;
+        std::vector<std::pair<float, GridIndex> > render_list;  ///< Non-empty segments by camera distance
+        std::unordered_set<GridIndex, GridIndexHasher> listed;  ///< Segments in render_list, used with it only
+        std::vector<Tango3DR_Mesh*> render_meshes;               ///< Segments of the last RenderList call
+        bool render_removed;                                     ///< Some segments of render_list got empty
+        TangoMeshPool pool;
+        double last_timestamp;
+        double rate;
+        unsigned int limit;
     };
 }
 #endif
@@ -16,6 +16,7 @@ namespace oc {
         void Setup3DR(double res, double dmin, double dmax, int noise);
 
         std::string Dataset() { return dataset; }
+        double Resolution() { return res_; }
         Tango3DR_CameraCalibration* Camera() { return &camera; }
         Tango3DR_ReconstructionContext Context() { return context; }
         TangoSupportPointCloudManager* Pointcloud() { return pointcloud; }
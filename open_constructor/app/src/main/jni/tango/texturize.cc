@@ -1,5 +1,6 @@
 #include <sstream>
 #include "data/image.h"
+#include "data/trace.h"
 #include "gl/camera.h"
 #include "tango/texturize.h"
 
@@ -8,6 +9,7 @@ namespace oc {
     TangoTexturize::TangoTexturize() : poses(0) {}
 
     void TangoTexturize::Add(Tango3DR_ImageBuffer t3dr_image, glm::mat4 image_matrix, std::string dataset) {
+        OC_TRACE_SCOPE("TangoTexturize::Add");
         //save frame
         width = t3dr_image.width;
         height = t3dr_image.height;
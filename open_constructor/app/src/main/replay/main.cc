@@ -0,0 +1,143 @@
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <sys/stat.h>
+#include <thread>
+#include <vector>
+#include "app.h"
+
+//host driver of the replay, without a capture file it synthesizes a scan of a room first
+
+namespace {
+    const double kResolution = 0.02;
+    const double kMinDepth = 0.1;
+    const double kMaxDepth = 4.0;
+    const int kNoise = 1;
+    const double kDepthRate = 5;
+    const double kColorRate = 30;
+    const int kDepthWidth = 224;
+    const int kDepthHeight = 172;
+    const int kColorWidth = 1280;
+    const int kColorHeight = 720;
+
+    std::string GetPath(std::string name) {
+        const char* tmp = getenv("TMPDIR");
+        return std::string(tmp ? tmp : "/tmp") + "/oc_replay_" + name;
+    }
+
+    TangoMatrixTransformData Pose(double timestamp) {
+        //device turns slowly around the center of the room
+        glm::mat4 matrix = glm::translate(glm::mat4(1), glm::vec3(0, 1.5f, 0));
+        matrix = glm::rotate(matrix, (float) timestamp * 0.2f, glm::vec3(0, 1, 0));
+        TangoMatrixTransformData transform;
+        transform.timestamp = timestamp;
+        transform.status_code = TANGO_POSE_VALID;
+        memcpy(transform.matrix, glm::value_ptr(matrix), sizeof(transform.matrix));
+        return transform;
+    }
+
+    void Synthesize(oc::TangoReplay& replay, std::string filename, double seconds) {
+        replay.StartRecording(filename);
+        std::vector<float> points(kDepthWidth * kDepthHeight * 4);
+        std::vector<unsigned char> yuv(kColorWidth * kColorHeight * 3 / 2);
+        int depth = 0, color = 0;
+        while (true) {
+            double depth_time = depth / kDepthRate;
+            double color_time = color / kColorRate;
+            if ((depth_time > seconds) && (color_time > seconds))
+                break;
+            if (depth_time <= color_time) {
+                //wall with a rippled surface in front of the depth camera
+                for (int y = 0; y < kDepthHeight; y++) {
+                    for (int x = 0; x < kDepthWidth; x++) {
+                        float* p = &points[(y * kDepthWidth + x) * 4];
+                        float dx = (x - kDepthWidth * 0.5f) / (kDepthWidth * 0.8f);
+                        float dy = (y - kDepthHeight * 0.5f) / (kDepthWidth * 0.8f);
+                        float z = 2.5f + 0.1f * glm::sin(dx * 10.0f + (float) depth_time) * glm::cos(dy * 10.0f);
+                        p[0] = dx * z;
+                        p[1] = dy * z;
+                        p[2] = z;
+                        p[3] = 1;
+                    }
+                }
+                TangoPointCloud cloud;
+                memset(&cloud, 0, sizeof(TangoPointCloud));
+                cloud.timestamp = depth_time;
+                cloud.num_points = kDepthWidth * kDepthHeight;
+                cloud.points = (float (*)[4]) points.data();
+                replay.AddPointCloud(&cloud, Pose(depth_time));
+                depth++;
+            } else {
+                //moving gradient in luma, neutral chroma
+                for (int y = 0; y < kColorHeight; y++)
+                    for (int x = 0; x < kColorWidth; x++)
+                        yuv[y * kColorWidth + x] = (unsigned char) ((x + y + color * 4) & 255);
+                memset(yuv.data() + kColorWidth * kColorHeight, 128, kColorWidth * kColorHeight / 2);
+                TangoImageBuffer buffer;
+                memset(&buffer, 0, sizeof(TangoImageBuffer));
+                buffer.width = kColorWidth;
+                buffer.height = kColorHeight;
+                buffer.stride = kColorWidth;
+                buffer.timestamp = color_time;
+                buffer.format = TANGO_HAL_PIXEL_FORMAT_YCrCb_420_SP;
+                buffer.data = yuv.data();
+                replay.AddFrame(&buffer, Pose(color_time));
+                color++;
+            }
+        }
+        replay.StopRecording();
+        printf("Synthesized %d clouds and %d frames into %s\n", depth, color, filename.c_str());
+    }
+}
+
+int main(int argc, char** argv) {
+    bool realtime = false;
+    double seconds = 5;
+    std::string filename;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--realtime")
+            realtime = true;
+        else if ((arg == "--seconds") && (i + 1 < argc))
+            seconds = atof(argv[++i]);
+        else if (arg[0] != '-')
+            filename = arg;
+        else {
+            printf("Usage: %s [--realtime] [--seconds synthesized_length] [capture]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (filename.empty()) {
+        oc::TangoReplay writer;
+        filename = GetPath("capture.ocr");
+        Synthesize(writer, filename, seconds);
+    }
+
+    //frames integrated during replay are stored as a dataset like on the device
+    std::string dataset = GetPath("dataset");
+    mkdir(dataset.c_str(), 0755);
+    oc::App* app = new oc::App();
+    app->OnTangoServiceConnected(0, 0, kResolution, kMinDepth, kMaxDepth, kNoise, false, dataset);
+    app->OnSurfaceChanged(kColorWidth, kColorHeight);
+
+    //render thread competes for the locks as in the app
+    std::atomic<bool> running(true);
+    std::thread render([app, &running] {
+        while (running) {
+            app->OnDrawFrame();
+            std::this_thread::sleep_for(std::chrono::milliseconds(16));
+        }
+    });
+    app->Replay(filename, realtime);
+    running = false;
+    render.join();
+    printf("%s\n%s%s", app->GetEvent().c_str(), app->GetLockReport().c_str(), app->GetMeshPoolStats().c_str());
+#ifdef OC_TRACE
+    std::string trace = GetPath("trace.json");
+    if (app->ExportTrace(trace))
+        printf("%sTrace written into %s\n", app->GetTraceStats().c_str(), trace.c_str());
+#endif
+    delete app;
+    return EXIT_SUCCESS;
+}